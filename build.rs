@@ -1,8 +1,10 @@
 fn main() {
     // Build CXX bridge
     cxx_build::bridge("src/cxx_bridge.rs")
+        .include("include")
         .flag_if_supported("-std=c++17")
         .compile("basis_rs_cxx");
 
     println!("cargo:rerun-if-changed=src/cxx_bridge.rs");
+    println!("cargo:rerun-if-changed=include/basis_rs/parquet/detail/task_callback.hpp");
 }
@@ -1,6 +1,15 @@
 #include <basis_rs/parquet/parquet.hpp>
+#include <sys/resource.h>
+
 #include <chrono>
+#include <cstdint>
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 // Test file path
 const char* TEST_FILE =
@@ -28,6 +37,71 @@ inline const basis_rs::ParquetCodec<TickData>& basis_rs::GetParquetCodec() {
   return codec;
 }
 
+// Synthetic mixed-type rows for the column type matrix and selectivity sweep
+struct MixedRow {
+  int64_t id;
+  std::string symbol;
+  bool flag;
+  absl::CivilSecond ts;
+  double price;
+  int64_t seq;   // == row index: sorted, row-group statistics are tight
+  double noise;  // uniform in [0, 1): every row group spans the full range
+};
+
+template <>
+inline const basis_rs::ParquetCodec<MixedRow>& basis_rs::GetParquetCodec() {
+  static basis_rs::ParquetCodec<MixedRow> codec = []() {
+    basis_rs::ParquetCodec<MixedRow> c;
+    c.Add("id", &MixedRow::id);
+    c.Add("symbol", &MixedRow::symbol);
+    c.Add("flag", &MixedRow::flag);
+    c.Add("ts", &MixedRow::ts);
+    c.Add("price", &MixedRow::price);
+    c.Add("seq", &MixedRow::seq);
+    c.Add("noise", &MixedRow::noise);
+    return c;
+  }();
+  return codec;
+}
+
+// Synthetic wide records for the transposition width sweep: N fields
+// alternating float/int32, each field a distinct base so it can be
+// registered with the codec by member pointer.
+template <size_t I>
+struct WideField {
+  std::conditional_t<I % 2 == 0, float, int32_t> v;
+};
+
+template <typename Seq>
+struct WideBase;
+
+template <size_t... I>
+struct WideBase<std::index_sequence<I...>> : WideField<I>... {};
+
+template <size_t N>
+struct WideRecord : WideBase<std::make_index_sequence<N>> {};
+
+template <size_t N, size_t... I>
+basis_rs::ParquetCodec<WideRecord<N>> MakeWideCodec(std::index_sequence<I...>) {
+  basis_rs::ParquetCodec<WideRecord<N>> c;
+  (c.Add("f" + std::to_string(I), &WideField<I>::v), ...);
+  return c;
+}
+
+#define DEFINE_WIDE_CODEC(N)                                                \
+  template <>                                                               \
+  inline const basis_rs::ParquetCodec<WideRecord<N>>&                       \
+  basis_rs::GetParquetCodec() {                                             \
+    static auto codec = MakeWideCodec<N>(std::make_index_sequence<N>{});    \
+    return codec;                                                           \
+  }
+
+DEFINE_WIDE_CODEC(4)
+DEFINE_WIDE_CODEC(8)
+DEFINE_WIDE_CODEC(16)
+DEFINE_WIDE_CODEC(32)
+DEFINE_WIDE_CODEC(64)
+
 template <typename F>
 double benchmark(const char* name, F&& func, int iterations = 3) {
   // Warm up
@@ -46,6 +120,271 @@ double benchmark(const char* name, F&& func, int iterations = 3) {
   return avg_ms;
 }
 
+// Column-at-a-time transposition (one full pass over the records per field),
+// the layout-naive baseline for the blocked codec reader.
+template <size_t N, size_t... I>
+void ReadColumnAtATime(const basis_rs::DataFrame& df,
+                       std::vector<WideRecord<N>>& records,
+                       std::index_sequence<I...>) {
+  auto read_field = [&]<size_t J>(std::integral_constant<size_t, J>) {
+    using T = decltype(WideField<J>::v);
+    auto col = df.GetColumn<T>("f" + std::to_string(J));
+    size_t row = 0;
+    for (size_t c = 0; c < col.NumChunks(); ++c) {
+      for (T v : col.Chunk(c)) records[row++].WideField<J>::v = v;
+    }
+  };
+  (read_field(std::integral_constant<size_t, I>{}), ...);
+}
+
+// Write and read back ~16M cells of WideRecord<N>, reporting ns per cell.
+template <size_t N>
+void BenchmarkWidth(const std::filesystem::path& dir) {
+  constexpr size_t kCells = 16 * 1024 * 1024;
+  const size_t rows = kCells / N;
+  std::vector<WideRecord<N>> data(rows);
+  [&]<size_t... I>(std::index_sequence<I...>) {
+    for (size_t r = 0; r < rows; ++r) {
+      ((data[r].WideField<I>::v = static_cast<decltype(WideField<I>::v)>(r + I)),
+       ...);
+    }
+  }(std::make_index_sequence<N>{});
+
+  auto path = dir / ("wide_" + std::to_string(N) + ".parquet");
+  std::string prefix = std::to_string(N) + " fields: ";
+  auto per_cell = [&](double ms) { return ms * 1e6 / (rows * N); };
+
+  double write_ms = benchmark((prefix + "WriteRecords (uncompressed)").c_str(), [&]() {
+    basis_rs::ParquetWriter<WideRecord<N>> writer(path);
+    writer.WithCompression("uncompressed");
+    writer.WriteRecords(data);
+    writer.Finish();
+  });
+
+  basis_rs::DataFrame df(path);
+  double blocked_ms = benchmark((prefix + "ReadAllAs (blocked)").c_str(), [&]() {
+    auto records = df.ReadAllAs<WideRecord<N>>();
+    (void)records.size();
+  });
+  double naive_ms = benchmark((prefix + "column-at-a-time").c_str(), [&]() {
+    std::vector<WideRecord<N>> records(df.NumRows());
+    ReadColumnAtATime<N>(df, records, std::make_index_sequence<N>{});
+  });
+
+  std::cout << prefix << "write " << per_cell(write_ms) << " ns/cell, read "
+            << per_cell(blocked_ms) << " ns/cell (blocked) vs "
+            << per_cell(naive_ms) << " ns/cell (column-at-a-time)" << std::endl;
+}
+
+constexpr size_t kMixedRows = 4 * 1024 * 1024;
+
+// Write kMixedRows MixedRow records in 128K-row groups.
+void WriteMixedFile(const std::filesystem::path& path) {
+  basis_rs::ParquetWriter<MixedRow> writer(path);
+  writer.WithCompression("snappy").WithRowGroupSize(128 * 1024);
+  const absl::CivilSecond open(2025, 1, 2, 9, 30, 0);
+  uint64_t state = 42;
+  for (size_t i = 0; i < kMixedRows; ++i) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    double noise = (state >> 11) * (1.0 / 9007199254740992.0);
+    writer.Emplace(static_cast<int64_t>(i),
+                   "SYM" + std::to_string(i % 5000), (i & 1) == 0,
+                   open + static_cast<int64_t>(i / 1000), 10.0 + noise * 90.0,
+                   static_cast<int64_t>(i), noise);
+  }
+  writer.Finish();
+}
+
+// Per-type read cost: zero-copy numerics vs the copying string/bool paths
+// and datetime access with civil-time conversion.
+void BenchmarkColumnTypes(const std::filesystem::path& path) {
+  basis_rs::DataFrame df(path);
+  auto per_row = [](double ms) { return ms * 1e6 / kMixedRows; };
+  auto report = [&](const char* name, double ms) {
+    std::cout << "  " << name << ": " << per_row(ms) << " ns/row" << std::endl;
+  };
+
+  double i64_ms = benchmark("int64 GetColumn + sum", [&]() {
+    int64_t sum = 0;
+    for (int64_t v : df.GetColumn<int64_t>("id")) sum += v;
+    (void)sum;
+  });
+  double f64_ms = benchmark("double GetColumn + sum", [&]() {
+    double sum = 0;
+    for (double v : df.GetColumn<double>("price")) sum += v;
+    (void)sum;
+  });
+  double str_ms = benchmark("GetStringColumn", [&]() {
+    auto symbols = df.GetStringColumn("symbol");
+    (void)symbols.size();
+  });
+  // No zero-copy accessor for bit-packed bools; this is the codec's path
+  double bool_ms = benchmark("bool column (unpacked copy)", [&]() {
+    auto flags = basis_rs::ffi::parquet_df_get_bool_column(df.Handle(), "flag");
+    size_t set = 0;
+    for (bool f : flags) set += f;
+    (void)set;
+  });
+  double dt_ms = benchmark("GetDateTimeColumn (raw ms)", [&]() {
+    int64_t last = 0;
+    for (int64_t ms : basis_rs::GetDateTimeColumn(df, "ts")) last = ms;
+    (void)last;
+  });
+  double civil_ms = benchmark("GetDateTimeColumn + CivilSecond", [&]() {
+    const auto& tz = basis_rs::GetShanghaiTimeZone();
+    absl::CivilSecond last;
+    for (int64_t ms : basis_rs::GetDateTimeColumn(df, "ts")) {
+      last = absl::ToCivilSecond(absl::FromUnixMillis(ms), tz);
+    }
+    (void)last;
+  });
+
+  report("int64", i64_ms);
+  report("double", f64_ms);
+  report("string", str_ms);
+  report("bool", bool_ms);
+  report("datetime", dt_ms);
+  report("datetime+civil", civil_ms);
+}
+
+// Filter pushdown vs full read + C++ filtering across selectivities, on a
+// sorted column (row groups can be skipped) and a uniformly random one
+// (every row group must be decoded).
+void BenchmarkSelectivity(const std::filesystem::path& path) {
+  for (double selectivity : {0.001, 0.01, 0.1, 0.5, 1.0}) {
+    const int64_t seq_cut = static_cast<int64_t>(kMixedRows * selectivity);
+    std::string pct = std::to_string(selectivity * 100) + "%";
+
+    double seq_push = benchmark(("seq  " + pct + " pushdown").c_str(), [&]() {
+      auto df = basis_rs::DataFrame::Open(path)
+                    .Select({"id", "price"})
+                    .Filter("seq", basis_rs::Lt, seq_cut)
+                    .Collect();
+      double sum = 0;
+      for (double v : df.GetColumn<double>("price")) sum += v;
+      (void)sum;
+    });
+    double seq_full = benchmark(("seq  " + pct + " full read").c_str(), [&]() {
+      basis_rs::DataFrame df(path, {"id", "price", "seq"});
+      auto seq = df.GetColumn<int64_t>("seq");
+      auto price = df.GetColumn<double>("price");
+      double sum = 0;
+      auto p = price.begin();
+      for (auto s = seq.begin(); s != seq.end(); ++s, ++p) {
+        if (*s < seq_cut) sum += *p;
+      }
+      (void)sum;
+    });
+    double noise_push = benchmark(("noise " + pct + " pushdown").c_str(), [&]() {
+      auto df = basis_rs::DataFrame::Open(path)
+                    .Select({"id", "price"})
+                    .Filter("noise", basis_rs::Lt, selectivity)
+                    .Collect();
+      double sum = 0;
+      for (double v : df.GetColumn<double>("price")) sum += v;
+      (void)sum;
+    });
+    double noise_full = benchmark(("noise " + pct + " full read").c_str(), [&]() {
+      basis_rs::DataFrame df(path, {"id", "price", "noise"});
+      auto noise = df.GetColumn<double>("noise");
+      auto price = df.GetColumn<double>("price");
+      double sum = 0;
+      auto p = price.begin();
+      for (auto n = noise.begin(); n != noise.end(); ++n, ++p) {
+        if (*n < selectivity) sum += *p;
+      }
+      (void)sum;
+    });
+
+    std::cout << "  " << pct << ": sorted pushdown speedup "
+              << seq_full / seq_push << "x, random pushdown speedup "
+              << noise_full / noise_push << "x" << std::endl;
+  }
+}
+
+// Bytes this process has read via read()/pread() so far (/proc/self/io
+// "rchar"; includes page-cache hits, so it measures decode volume, not disk).
+// Memory-mapped file reads do not show up here; see MinorFaultCount().
+int64_t ReadCharCount() {
+  std::ifstream io("/proc/self/io");
+  std::string key;
+  int64_t value = 0;
+  while (io >> key >> value) {
+    if (key == "rchar:") return value;
+  }
+  return 0;
+}
+
+// Minor page faults so far. Touching pages of a memory-mapped file (and
+// fresh heap pages) fault once each, so the delta approximates bytes touched.
+int64_t MinorFaultCount() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_minflt;
+}
+
+// One-minute window over a time-sorted day: coarse row groups with default
+// pages vs fine row groups with small pages, both with statistics.
+void BenchmarkTimeWindow(const std::filesystem::path& dir) {
+  constexpr size_t kRows = 4 * 1024 * 1024;
+  const absl::CivilSecond open(2025, 1, 2, 9, 30, 0);
+  const auto& tz = basis_rs::GetShanghaiTimeZone();
+  const int64_t open_ms = absl::ToUnixMillis(absl::FromCivil(open, tz));
+  constexpr int64_t kDayMs = 4 * 3600 * 1000;
+
+  std::vector<int64_t> ts(kRows);
+  std::vector<double> price(kRows);
+  std::vector<int64_t> volume(kRows);
+  for (size_t i = 0; i < kRows; ++i) {
+    ts[i] = open_ms + static_cast<int64_t>(i * kDayMs / kRows);
+    price[i] = 10.0 + (i % 997) * 0.01;
+    volume[i] = static_cast<int64_t>(i % 10000);
+  }
+
+  struct Layout {
+    const char* name;
+    size_t row_group_size;
+    size_t data_page_size;
+  };
+  for (const Layout& layout : {Layout{"500K groups, default pages", 500000, 0},
+                               Layout{"16K groups, 64 KiB pages", 16 * 1024, 64 * 1024}}) {
+    auto path = dir / "time_window.parquet";
+    {
+      basis_rs::ColumnarParquetWriter writer(path);
+      writer.WithCompression("snappy")
+          .WithRowGroupSize(layout.row_group_size)
+          .WithDataPageSize(layout.data_page_size);
+      writer.AddDateTimeColumn("ts", ts.data(), ts.size());
+      writer.AddColumn("price", price.data(), price.size());
+      writer.AddColumn("volume", volume.data(), volume.size());
+      writer.WriteBatch();
+      writer.Finish();
+    }
+
+    auto from = absl::FromCivil(open + 3600, tz);
+    auto to = from + absl::Minutes(1);
+    size_t rows = 0;
+    int64_t rchar_before = ReadCharCount();
+    int64_t faults_before = MinorFaultCount();
+    double ms = benchmark(layout.name, [&]() {
+      auto df = basis_rs::DataFrame::Open(path)
+                    .Filter("ts", basis_rs::Ge, from)
+                    .Filter("ts", basis_rs::Lt, to)
+                    .Collect();
+      rows = df.NumRows();
+    });
+    // benchmark() runs the query once to warm up plus 3 timed iterations
+    constexpr double kQueries = 4.0;
+    double read_mib = (ReadCharCount() - rchar_before) / kQueries / (1024 * 1024);
+    double touched_mib = (MinorFaultCount() - faults_before) * 4096.0 /
+                         kQueries / (1024 * 1024);
+    std::cout << "  " << rows << " rows, per query: " << read_mib
+              << " MiB read(), " << touched_mib << " MiB pages touched, file "
+              << std::filesystem::file_size(path) / (1024 * 1024) << " MiB, "
+              << ms << " ms" << std::endl;
+  }
+}
+
 int main() {
   std::cout << "=== C++ Parquet Performance Benchmark ===" << std::endl;
   std::cout << "Test file: " << TEST_FILE << std::endl << std::endl;
@@ -163,6 +502,44 @@ int main() {
     (void)df.NumRows();
   });
 
+  // Benchmark 6: SharedDataFrame fan-out (threads read disjoint columns)
+  std::cout << std::endl << "--- SharedDataFrame fan-out ---" << std::endl;
+  {
+    basis_rs::SharedDataFrame shared(basis_rs::DataFrame{TEST_FILE});
+    std::vector<basis_rs::ffi::ColumnInfo> numeric_cols;
+    for (const auto& info : shared.Columns()) {
+      if (info.dtype == basis_rs::ffi::ColumnType::Float32 ||
+          info.dtype == basis_rs::ffi::ColumnType::Int32) {
+        numeric_cols.push_back(info);
+      }
+    }
+    std::cout << "Columns: " << numeric_cols.size() << " (f32/i32)" << std::endl;
+
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned n = 1; n <= max_threads; n *= 2) {
+      std::string label = "Fan-out column sums, " + std::to_string(n) + " threads";
+      benchmark(label.c_str(), [&]() {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < n; ++t) {
+          // Each worker owns a copy of the handle and reads every n-th column
+          workers.emplace_back([shared, t, n, &numeric_cols]() {
+            double sum = 0;
+            for (size_t c = t; c < numeric_cols.size(); c += n) {
+              std::string name(numeric_cols[c].name);
+              if (numeric_cols[c].dtype == basis_rs::ffi::ColumnType::Float32) {
+                for (float v : shared.GetColumn<float>(name)) sum += v;
+              } else {
+                for (int32_t v : shared.GetColumn<int32_t>(name)) sum += v;
+              }
+            }
+            (void)sum;
+          });
+        }
+        for (auto& w : workers) w.join();
+      });
+    }
+  }
+
   // Summary
   std::cout << std::endl << "=== Read Summary ===" << std::endl;
   std::cout << "Rows: " << num_rows << std::endl;
@@ -321,6 +698,30 @@ int main() {
   std::cout << "Columnar (snappy):    " << columnar_snappy_time << " ms ("
             << rows_m / (columnar_snappy_time / 1000.0) << " M rows/s)" << std::endl;
 
+  // ==================== Column Type Matrix ====================
+  // Synthetic file: the struct writers have no null path, so nullable
+  // columns are only covered by the real tick file above.
+  auto mixed_path = tmp_dir / "mixed.parquet";
+  WriteMixedFile(mixed_path);
+  std::cout << std::endl << "--- Column type matrix ---" << std::endl;
+  BenchmarkColumnTypes(mixed_path);
+
+  // ==================== Filter Selectivity Sweep ====================
+  std::cout << std::endl << "--- Filter selectivity sweep ---" << std::endl;
+  BenchmarkSelectivity(mixed_path);
+
+  // ==================== Time-Window Reads ====================
+  std::cout << std::endl << "--- Time-window reads (1 minute of 4h) ---" << std::endl;
+  BenchmarkTimeWindow(tmp_dir);
+
+  // ==================== Record Width Sweep ====================
+  std::cout << std::endl << "--- Record width sweep ---" << std::endl;
+  BenchmarkWidth<4>(tmp_dir);
+  BenchmarkWidth<8>(tmp_dir);
+  BenchmarkWidth<16>(tmp_dir);
+  BenchmarkWidth<32>(tmp_dir);
+  BenchmarkWidth<64>(tmp_dir);
+
   // Cleanup
   std::filesystem::remove_all(tmp_dir);
 
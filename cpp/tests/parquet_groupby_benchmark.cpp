@@ -0,0 +1,138 @@
+// Group-by benchmark: basis_rs::GroupBy against a naive std::unordered_map
+// loop over the same columns, for a range of key cardinalities.
+//
+// Usage: parquet_groupby_benchmark [rows] [threads]
+//
+// Aggregates sum(price * qty) and sum(qty) per key, i.e. the inputs of a
+// per-StockId VWAP. The file has 1M-row row groups; GroupBy is timed on the
+// columns as read (one chunk per row group) and after Rechunk().
+
+#include <basis_rs/parquet/parquet.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+struct Vwap {
+  double pv = 0;
+  double v = 0;
+};
+
+template <typename Fn>
+double BestMs(int runs, Fn&& fn) {
+  double best = 1e300;
+  for (int i = 0; i < runs; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(
+        best, std::chrono::duration<double, std::milli>(end - start).count());
+  }
+  return best;
+}
+
+int main(int argc, char** argv) {
+  size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+  size_t threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10)
+                            : std::max(1u, std::thread::hardware_concurrency());
+  constexpr int kRuns = 5;
+
+  std::cout << "=== C++ GroupBy Benchmark ===" << std::endl;
+  std::cout << "Rows: " << rows << ", threads: " << threads << std::endl;
+
+  auto tmp_dir =
+      std::filesystem::temp_directory_path() / "basis_rs_groupby_bench";
+  std::filesystem::create_directories(tmp_dir);
+
+  std::cout << std::setw(12) << "keys" << std::setw(16) << "unordered ms"
+            << std::setw(14) << "chunked ms" << std::setw(14) << "GroupBy ms"
+            << std::setw(10) << "speedup" << std::endl;
+
+  for (size_t cardinality : {100, 5'000, 1'000'000}) {
+    std::mt19937_64 rng(42);
+    std::vector<int64_t> ids(rows);
+    std::vector<double> prices(rows);
+    std::vector<double> qtys(rows);
+    for (size_t i = 0; i < rows; ++i) {
+      ids[i] = static_cast<int64_t>(rng() % cardinality);
+      prices[i] = 10.0 + static_cast<double>(rng() % 10000) * 0.01;
+      qtys[i] = static_cast<double>(rng() % 100 + 1);
+    }
+
+    auto path = tmp_dir / ("keys_" + std::to_string(cardinality) + ".parquet");
+    {
+      basis_rs::ColumnarParquetWriter writer(path);
+      writer.WithRowGroupSize(1'000'000);
+      writer.AddColumn("id", ids.data(), ids.size());
+      writer.AddColumn("price", prices.data(), prices.size());
+      writer.AddColumn("qty", qtys.data(), qtys.size());
+      writer.Finish();
+    }
+
+    basis_rs::DataFrame df(path);
+    auto aggregate = [&](const basis_rs::ColumnAccessor<int64_t>& id,
+                         const basis_rs::ColumnAccessor<double>& px,
+                         const basis_rs::ColumnAccessor<double>& qty) {
+      return basis_rs::GroupBy(id).WithThreads(threads).Aggregate<Vwap>(
+          std::tuple(px, qty), [](Vwap& s, double p, double q) {
+            s.pv += p * q;
+            s.v += q;
+          });
+    };
+
+    size_t chunked_groups = 0;
+    double chunked_ms = BestMs(kRuns, [&] {
+      chunked_groups = aggregate(df.GetColumn<int64_t>("id"),
+                                 df.GetColumn<double>("price"),
+                                 df.GetColumn<double>("qty"))
+                           .size();
+    });
+
+    df.Rechunk();
+    auto id_col = df.GetColumn<int64_t>("id");
+    auto px_col = df.GetColumn<double>("price");
+    auto qty_col = df.GetColumn<double>("qty");
+
+    size_t naive_groups = 0;
+    double naive_ms = BestMs(kRuns, [&] {
+      std::unordered_map<int64_t, Vwap> groups;
+      auto id = id_col.begin();
+      auto px = px_col.begin();
+      auto qty = qty_col.begin();
+      for (; id != id_col.end(); ++id, ++px, ++qty) {
+        auto& s = groups[*id];
+        s.pv += *px * *qty;
+        s.v += *qty;
+      }
+      naive_groups = groups.size();
+    });
+
+    size_t kernel_groups = 0;
+    double kernel_ms = BestMs(kRuns, [&] {
+      kernel_groups = aggregate(id_col, px_col, qty_col).size();
+    });
+
+    if (naive_groups != kernel_groups || naive_groups != chunked_groups) {
+      std::cerr << "Group count mismatch: " << naive_groups << " vs "
+                << kernel_groups << " / " << chunked_groups << std::endl;
+      return 1;
+    }
+    std::cout << std::fixed << std::setprecision(2) << std::setw(12)
+              << cardinality << std::setw(16) << naive_ms << std::setw(14)
+              << chunked_ms << std::setw(14) << kernel_ms << std::setw(9)
+              << naive_ms / kernel_ms << "x" << std::endl;
+  }
+
+  std::filesystem::remove_all(tmp_dir);
+  return 0;
+}
@@ -0,0 +1,262 @@
+// Peak-memory benchmark: runs each case in a forked child and reports the
+// RSS high-water mark and C++ heap allocations of the measured section.
+//
+// Usage: parquet_memory_benchmark [file.parquet]
+//   Without a file, a synthetic 4M-row file is generated first.
+//
+// Allocation counts cover C++ operator new only; Rust/Polars allocations
+// show up in the RSS numbers.
+
+#include <basis_rs/parquet/parquet.hpp>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <span>
+#include <string>
+#include <vector>
+
+// ==================== Allocation Counting ====================
+
+namespace {
+std::atomic<uint64_t> g_alloc_count{0};
+std::atomic<uint64_t> g_alloc_bytes{0};
+}  // namespace
+
+void* operator new(size_t size) {
+  g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+  g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// ==================== Test Data ====================
+
+struct MemRow {
+  int64_t id;
+  std::string symbol;
+  double price;
+  int32_t qty;
+};
+
+template <>
+inline const basis_rs::ParquetCodec<MemRow>& basis_rs::GetParquetCodec() {
+  static basis_rs::ParquetCodec<MemRow> codec = []() {
+    basis_rs::ParquetCodec<MemRow> c;
+    c.Add("id", &MemRow::id);
+    c.Add("symbol", &MemRow::symbol);
+    c.Add("price", &MemRow::price);
+    c.Add("qty", &MemRow::qty);
+    return c;
+  }();
+  return codec;
+}
+
+constexpr size_t kRows = 4 * 1024 * 1024;
+
+std::vector<MemRow> MakeRows() {
+  std::vector<MemRow> rows;
+  rows.reserve(kRows);
+  for (size_t i = 0; i < kRows; ++i) {
+    rows.push_back({static_cast<int64_t>(i), "SYM" + std::to_string(i % 5000),
+                    10.0 + (i % 1000) * 0.01, static_cast<int32_t>(i % 100)});
+  }
+  return rows;
+}
+
+// ==================== Measurement ====================
+
+/// Read a "VmXXX:  <kB> kB" field from /proc/self/status (0 if absent).
+int64_t ReadStatusKb(const std::string& field) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind(field + ":", 0) == 0) {
+      return std::stoll(line.substr(field.size() + 1));
+    }
+  }
+  return 0;
+}
+
+/// Reset VmHWM to the current RSS (Linux >= 4.0). Returns false if the
+/// kernel does not support it, in which case peaks include setup.
+bool ResetPeakRss() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+  clear_refs.flush();
+  return clear_refs.good();
+}
+
+struct CaseResult {
+  int64_t baseline_kb;
+  int64_t peak_kb;
+  uint64_t allocs;
+  uint64_t alloc_bytes;
+  bool peak_reset;
+};
+
+/// Run setup() then run() in a forked child. Only run() is measured: the
+/// RSS high-water mark is reset and allocation counters zeroed in between.
+void RunCase(const std::string& name, const std::function<void()>& setup,
+             const std::function<void()>& run) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    std::perror("pipe");
+    return;
+  }
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(fds[0]);
+    setup();
+    CaseResult r{};
+    r.peak_reset = ResetPeakRss();
+    r.baseline_kb = ReadStatusKb("VmRSS");
+    g_alloc_count = 0;
+    g_alloc_bytes = 0;
+    run();
+    r.allocs = g_alloc_count.load();
+    r.alloc_bytes = g_alloc_bytes.load();
+    r.peak_kb = ReadStatusKb("VmHWM");
+    ssize_t written = write(fds[1], &r, sizeof(r));
+    _exit(written == sizeof(r) ? 0 : 1);
+  }
+
+  close(fds[1]);
+  CaseResult r{};
+  ssize_t got = read(fds[0], &r, sizeof(r));
+  close(fds[0]);
+
+  int status = 0;
+  rusage usage{};
+  wait4(pid, &status, 0, &usage);
+  if (got != sizeof(r) || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    std::cout << std::left << std::setw(40) << name << "FAILED" << std::endl;
+    return;
+  }
+  if (r.peak_kb == 0) r.peak_kb = usage.ru_maxrss;  // no /proc: use rusage
+
+  std::cout << std::left << std::setw(40) << name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(10)
+            << (r.peak_kb - r.baseline_kb) / 1024.0 << std::setw(10)
+            << r.peak_kb / 1024.0 << std::setw(12) << r.allocs << std::setw(12)
+            << r.alloc_bytes / (1024.0 * 1024.0)
+            << (r.peak_reset ? "" : "  (peak includes setup)") << std::endl;
+}
+
+int main(int argc, char** argv) {
+  auto tmp_dir =
+      std::filesystem::temp_directory_path() / "basis_rs_memory_bench";
+  std::filesystem::create_directories(tmp_dir);
+  auto write_path = tmp_dir / "write.parquet";
+
+  bool synthetic = argc <= 1;
+  std::filesystem::path path =
+      synthetic ? tmp_dir / "synthetic.parquet" : std::filesystem::path(argv[1]);
+
+  std::cout << "=== C++ Parquet Peak Memory Benchmark ===" << std::endl;
+  std::cout << "File: " << path << std::endl << std::endl;
+  std::cout << std::left << std::setw(40) << "case" << std::right
+            << std::setw(10) << "peak+MB" << std::setw(10) << "peakMB"
+            << std::setw(12) << "allocs" << std::setw(12) << "allocMB"
+            << std::endl;
+
+  if (synthetic) {
+    // Generate in a child so the parent stays small for later forks
+    RunCase("(generate synthetic file)", [] {}, [&] {
+      basis_rs::ParquetWriter<MemRow> writer(path);
+      writer.WithRowGroupSize(128 * 1024);
+      writer.WriteRecords(MakeRows());
+      writer.Finish();
+    });
+  }
+
+  // ---- Reads ----
+  RunCase("DataFrame open", [] {}, [&] {
+    basis_rs::DataFrame df(path);
+    (void)df.NumRows();
+  });
+
+  {
+    std::unique_ptr<basis_rs::DataFrame> df;
+    RunCase("Rechunk (after open)",
+            [&] { df = std::make_unique<basis_rs::DataFrame>(path); },
+            [&] { df->Rechunk(); });
+  }
+
+  if (synthetic) {
+    RunCase("ReadAllAs<MemRow>", [] {}, [&] {
+      basis_rs::DataFrame df(path);
+      auto rows = df.ReadAllAs<MemRow>();
+      (void)rows.size();
+    });
+
+    RunCase("ForEachRecords<MemRow> (4096)", [] {}, [&] {
+      size_t n = 0;
+      basis_rs::DataFrame::Open(path).ForEachRecords<MemRow>(
+          4096, [&](std::span<const MemRow> batch) { n += batch.size(); });
+    });
+
+    RunCase("Open().Filter(10%).Collect()", [] {}, [&] {
+      auto df = basis_rs::DataFrame::Open(path)
+                    .Filter("id", basis_rs::Lt,
+                            static_cast<int64_t>(kRows / 10))
+                    .Collect();
+      (void)df.NumRows();
+    });
+
+    // ---- Writers (input records are built in setup, outside the peak) ----
+    std::vector<MemRow> rows;
+    RunCase("ParquetWriter<MemRow> (buffer all)", [&] { rows = MakeRows(); },
+            [&] {
+              basis_rs::ParquetWriter<MemRow> writer(write_path);
+              for (const auto& r : rows) writer.WriteRecord(r);
+              writer.Finish();
+            });
+
+    RunCase("ParquetWriter<MemRow> (128K groups)", [&] { rows = MakeRows(); },
+            [&] {
+              basis_rs::ParquetWriter<MemRow> writer(write_path);
+              writer.WithRowGroupSize(128 * 1024);
+              for (const auto& r : rows) writer.WriteRecord(r);
+              writer.Finish();
+            });
+
+    std::vector<int64_t> ids;
+    std::vector<double> prices;
+    RunCase("ColumnarParquetWriter (128K groups)",
+            [&] {
+              ids.resize(kRows);
+              prices.resize(kRows);
+              for (size_t i = 0; i < kRows; ++i) {
+                ids[i] = static_cast<int64_t>(i);
+                prices[i] = 10.0 + (i % 1000) * 0.01;
+              }
+            },
+            [&] {
+              basis_rs::ColumnarParquetWriter writer(write_path);
+              writer.WithRowGroupSize(128 * 1024);
+              writer.AddColumn("id", ids.data(), ids.size());
+              writer.AddColumn("price", prices.data(), prices.size());
+              writer.WriteBatch();
+              writer.Finish();
+            });
+  }
+
+  std::filesystem::remove_all(tmp_dir);
+  return 0;
+}
@@ -0,0 +1,153 @@
+// Multi-core scaling benchmark: N threads (1..cores) concurrently opening
+// the same file, opening distinct files, or writing independent files.
+// Reports aggregate rows/s and per-operation latency percentiles.
+//
+// Usage: parquet_scaling_benchmark [ops_per_thread]
+//
+// All operations share the Polars global thread pool. Run with different
+// POLARS_MAX_THREADS values to see how pool size trades per-op latency
+// against aggregate throughput.
+
+#include <basis_rs/parquet/parquet.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr size_t kRowsPerFile = 1024 * 1024;
+
+struct ScalingResult {
+  double rows_per_sec;
+  double p50_ms;
+  double p95_ms;
+  double p99_ms;
+};
+
+double Percentile(const std::vector<double>& sorted, double p) {
+  size_t idx = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+  return sorted[idx];
+}
+
+/// Run op(thread_index) ops_per_thread times on each of n threads.
+/// Each op processes kRowsPerFile rows.
+ScalingResult RunScaling(unsigned n, int ops_per_thread,
+                         const std::function<void(unsigned)>& op) {
+  std::vector<std::vector<double>> latencies(n);
+  auto start = std::chrono::steady_clock::now();
+  {
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < n; ++t) {
+      workers.emplace_back([&, t]() {
+        latencies[t].reserve(ops_per_thread);
+        for (int i = 0; i < ops_per_thread; ++i) {
+          auto op_start = std::chrono::steady_clock::now();
+          op(t);
+          auto op_end = std::chrono::steady_clock::now();
+          latencies[t].push_back(
+              std::chrono::duration<double, std::milli>(op_end - op_start)
+                  .count());
+        }
+      });
+    }
+    for (auto& w : workers) w.join();
+  }
+  double wall_s = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+
+  std::vector<double> all;
+  for (const auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+  std::sort(all.begin(), all.end());
+
+  double total_rows = static_cast<double>(kRowsPerFile) * n * ops_per_thread;
+  return {total_rows / wall_s, Percentile(all, 0.50), Percentile(all, 0.95),
+          Percentile(all, 0.99)};
+}
+
+void WriteFile(const std::filesystem::path& path, const std::vector<int64_t>& ids,
+               const std::vector<double>& prices, const std::vector<float>& qtys) {
+  basis_rs::ColumnarParquetWriter writer(path);
+  writer.WithCompression("snappy").WithRowGroupSize(128 * 1024);
+  writer.AddColumn("id", ids.data(), ids.size());
+  writer.AddColumn("price", prices.data(), prices.size());
+  writer.AddColumn("qty", qtys.data(), qtys.size());
+  writer.WriteBatch();
+  writer.Finish();
+}
+
+void Sweep(const char* mode, unsigned max_threads, int ops_per_thread,
+           const std::function<void(unsigned)>& op) {
+  std::cout << std::endl << "--- " << mode << " ---" << std::endl;
+  std::cout << std::setw(8) << "threads" << std::setw(14) << "M rows/s"
+            << std::setw(10) << "p50 ms" << std::setw(10) << "p95 ms"
+            << std::setw(10) << "p99 ms" << std::endl;
+
+  std::vector<unsigned> counts;
+  for (unsigned n = 1; n < max_threads; n *= 2) counts.push_back(n);
+  counts.push_back(max_threads);
+
+  op(0);  // Warm up (page cache, pool start-up)
+  for (unsigned n : counts) {
+    auto r = RunScaling(n, ops_per_thread, op);
+    std::cout << std::fixed << std::setprecision(2) << std::setw(8) << n
+              << std::setw(14) << r.rows_per_sec / 1e6 << std::setw(10)
+              << r.p50_ms << std::setw(10) << r.p95_ms << std::setw(10)
+              << r.p99_ms << std::endl;
+  }
+}
+
+int main(int argc, char** argv) {
+  int ops_per_thread = argc > 1 ? std::atoi(argv[1]) : 8;
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << "=== C++ Parquet Scaling Benchmark ===" << std::endl;
+  std::cout << "Cores: " << cores
+            << ", Polars pool threads: " << basis_rs::ThreadPoolSize()
+            << ", rows/op: " << kRowsPerFile
+            << ", ops/thread: " << ops_per_thread << std::endl;
+
+  auto tmp_dir =
+      std::filesystem::temp_directory_path() / "basis_rs_scaling_bench";
+  std::filesystem::create_directories(tmp_dir);
+
+  std::vector<int64_t> ids(kRowsPerFile);
+  std::vector<double> prices(kRowsPerFile);
+  std::vector<float> qtys(kRowsPerFile);
+  for (size_t i = 0; i < kRowsPerFile; ++i) {
+    ids[i] = static_cast<int64_t>(i);
+    prices[i] = 10.0 + (i % 1000) * 0.01;
+    qtys[i] = static_cast<float>(i % 100);
+  }
+
+  std::vector<std::filesystem::path> inputs;
+  for (unsigned t = 0; t < cores; ++t) {
+    inputs.push_back(tmp_dir / ("input_" + std::to_string(t) + ".parquet"));
+    WriteFile(inputs.back(), ids, prices, qtys);
+  }
+
+  Sweep("Open identical file", cores, ops_per_thread, [&](unsigned) {
+    basis_rs::DataFrame df(inputs[0]);
+    (void)df.NumRows();
+  });
+
+  Sweep("Open distinct files", cores, ops_per_thread, [&](unsigned t) {
+    basis_rs::DataFrame df(inputs[t]);
+    (void)df.NumRows();
+  });
+
+  Sweep("Write independent files", cores, ops_per_thread, [&](unsigned t) {
+    WriteFile(tmp_dir / ("output_" + std::to_string(t) + ".parquet"), ids,
+              prices, qtys);
+  });
+
+  std::filesystem::remove_all(tmp_dir);
+  return 0;
+}
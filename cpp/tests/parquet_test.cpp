@@ -1,8 +1,19 @@
 #include <basis_rs/parquet/parquet.hpp>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <coroutine>
 #include <cstdio>
+#include <deque>
+#include <exception>
 #include <filesystem>
+#include <future>
+#include <map>
+#include <numeric>
 #include <gtest/gtest.h>
+#include <ranges>
+#include <span>
+#include <thread>
 
 #include "absl/time/civil_time.h"
 #include "absl/time/time.h"
@@ -1108,3 +1119,1667 @@ TEST_F(ParquetTest, ColumnarWriterDiscard)
 
   EXPECT_FALSE(fs::exists(path));
 }
+
+// ==================== Concat / HStack Tests ====================
+
+TEST_F(ParquetTest, DataFrameConcat)
+{
+  auto path1 = temp_dir_ / "concat_1.parquet";
+  auto path2 = temp_dir_ / "concat_2.parquet";
+
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path1);
+    writer.WriteRecord({1, "alice", 85.5});
+    writer.WriteRecord({2, "bob", 92.0});
+    writer.Finish();
+  }
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path2);
+    writer.WriteRecord({3, "charlie", 78.5});
+    writer.Finish();
+  }
+
+  std::vector<basis_rs::DataFrame> frames;
+  frames.emplace_back(path1);
+  frames.emplace_back(path2);
+  auto df = basis_rs::DataFrame::Concat(std::move(frames));
+
+  EXPECT_EQ(df.NumRows(), 3);
+  EXPECT_EQ(df.NumCols(), 3);
+
+  // Chunks are appended, not copied
+  auto ids = df.GetColumn<int64_t>("id");
+  EXPECT_GE(ids.NumChunks(), 2);
+  EXPECT_EQ(ids[0], 1);
+  EXPECT_EQ(ids[2], 3);
+
+  auto records = df.ReadAllAs<SimpleEntry>();
+  ASSERT_EQ(records.size(), 3);
+  EXPECT_EQ(records[2].name, "charlie");
+}
+
+TEST_F(ParquetTest, DataFrameConcatSchemaMismatch)
+{
+  auto path1 = temp_dir_ / "concat_mismatch_1.parquet";
+  auto path2 = temp_dir_ / "concat_mismatch_2.parquet";
+
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path1);
+    writer.WriteRecord({1, "alice", 85.5});
+    writer.Finish();
+  }
+  {
+    basis_rs::ParquetWriter<PartialEntry> writer(path2);
+    writer.WriteRecord({2, 92.0});
+    writer.Finish();
+  }
+
+  std::vector<basis_rs::DataFrame> frames;
+  frames.emplace_back(path1);
+  frames.emplace_back(path2);
+  EXPECT_THROW(basis_rs::DataFrame::Concat(std::move(frames)), std::exception);
+
+  EXPECT_THROW(basis_rs::DataFrame::Concat({}), std::invalid_argument);
+}
+
+TEST_F(ParquetTest, DataFrameHStack)
+{
+  auto left_path = temp_dir_ / "hstack_left.parquet";
+  auto right_path = temp_dir_ / "hstack_right.parquet";
+
+  std::vector<int64_t> ids = {1, 2, 3};
+  std::vector<double> factors = {0.1, 0.2, 0.3};
+  {
+    basis_rs::ColumnarParquetWriter writer(left_path);
+    writer.AddColumn("id", ids.data(), ids.size());
+    writer.Finish();
+  }
+  {
+    basis_rs::ColumnarParquetWriter writer(right_path);
+    writer.AddColumn("factor", factors.data(), factors.size());
+    writer.Finish();
+  }
+
+  basis_rs::DataFrame left(left_path);
+  basis_rs::DataFrame right(right_path);
+  auto df = basis_rs::DataFrame::HStack(left, right);
+
+  EXPECT_EQ(df.NumRows(), 3);
+  EXPECT_EQ(df.NumCols(), 2);
+
+  // Columns share buffers with the inputs
+  EXPECT_EQ(df.GetColumn<int64_t>("id").Chunk(0).data(),
+            left.GetColumn<int64_t>("id").Chunk(0).data());
+  EXPECT_DOUBLE_EQ(df.GetColumn<double>("factor")[2], 0.3);
+}
+
+TEST_F(ParquetTest, DataFrameHStackValidation)
+{
+  auto path1 = temp_dir_ / "hstack_len_1.parquet";
+  auto path2 = temp_dir_ / "hstack_len_2.parquet";
+
+  std::vector<int64_t> ids = {1, 2, 3};
+  std::vector<double> factors = {0.1, 0.2};
+  {
+    basis_rs::ColumnarParquetWriter writer(path1);
+    writer.AddColumn("id", ids.data(), ids.size());
+    writer.Finish();
+  }
+  {
+    basis_rs::ColumnarParquetWriter writer(path2);
+    writer.AddColumn("factor", factors.data(), factors.size());
+    writer.Finish();
+  }
+
+  basis_rs::DataFrame a(path1);
+  basis_rs::DataFrame b(path2);
+
+  // Row count mismatch
+  EXPECT_THROW(basis_rs::DataFrame::HStack(a, b), std::exception);
+  // Duplicate column names
+  EXPECT_THROW(basis_rs::DataFrame::HStack(a, a), std::exception);
+}
+
+// ==================== SharedDataFrame Tests ====================
+
+TEST_F(ParquetTest, SharedDataFrameCopy)
+{
+  auto path = temp_dir_ / "shared_copy.parquet";
+
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WriteRecord({1, "alice", 85.5});
+    writer.WriteRecord({2, "bob", 92.0});
+    writer.Finish();
+  }
+
+  basis_rs::SharedDataFrame shared(basis_rs::DataFrame{path});
+  basis_rs::SharedDataFrame copy = shared;
+
+  EXPECT_EQ(copy.NumRows(), 2);
+  EXPECT_EQ(copy.NumCols(), 3);
+
+  // Copies share the same underlying data
+  EXPECT_EQ(&shared.Handle(), &copy.Handle());
+  EXPECT_EQ(shared.GetColumn<int64_t>("id").Chunk(0).data(),
+            copy.GetColumn<int64_t>("id").Chunk(0).data());
+
+  // Accessors outlive the handle they were obtained from
+  auto ids = copy.GetColumn<int64_t>("id");
+  {
+    basis_rs::SharedDataFrame drop_me = std::move(copy);
+  }
+  EXPECT_EQ(ids[1], 2);
+
+  auto records = shared.ReadAllAs<SimpleEntry>();
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_EQ(records[1].name, "bob");
+}
+
+TEST_F(ParquetTest, SharedDataFrameConcurrentReads)
+{
+  auto path = temp_dir_ / "shared_concurrent.parquet";
+
+  const int n = 10000;
+  {
+    basis_rs::ParquetWriter<NumericEntry> writer(path);
+    writer.WithRowGroupSize(1000);
+    for (int i = 0; i < n; ++i)
+    {
+      writer.WriteRecord({i, i, static_cast<float>(i), static_cast<double>(i)});
+    }
+    writer.Finish();
+  }
+
+  basis_rs::SharedDataFrame shared(basis_rs::DataFrame{path});
+  const double expected = static_cast<double>(n - 1) * n / 2;
+
+  std::vector<std::thread> threads;
+  std::vector<int> failures(8, 0);
+  for (int t = 0; t < 8; ++t)
+  {
+    threads.emplace_back([shared, t, expected, &failures]()
+                         {
+      for (int iter = 0; iter < 20; ++iter) {
+        double sum = 0;
+        switch ((t + iter) % 4) {
+          case 0: for (auto v : shared.GetColumn<int32_t>("i32_val")) sum += v; break;
+          case 1: for (auto v : shared.GetColumn<int64_t>("i64_val")) sum += v; break;
+          case 2: for (auto v : shared.GetColumn<float>("f32_val")) sum += v; break;
+          case 3: for (auto v : shared.GetColumn<double>("f64_val")) sum += v; break;
+        }
+        if (sum != expected) ++failures[t];
+      } });
+  }
+  for (auto &th : threads)
+  {
+    th.join();
+  }
+
+  for (int t = 0; t < 8; ++t)
+  {
+    EXPECT_EQ(failures[t], 0) << "thread " << t;
+  }
+}
+
+// ==================== In-Memory Select / Filter Tests ====================
+
+TEST_F(ParquetTest, DataFrameSelectInMemory)
+{
+  auto path = temp_dir_ / "mem_select.parquet";
+
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WriteRecord({1, "alice", 85.5});
+    writer.WriteRecord({2, "bob", 92.0});
+    writer.Finish();
+  }
+
+  basis_rs::DataFrame df(path);
+  auto sub = df.Select({"score", "id"});
+
+  EXPECT_EQ(sub.NumRows(), 2);
+  ASSERT_EQ(sub.NumCols(), 2);
+  EXPECT_EQ(std::string(sub.Columns()[0].name), "score");
+
+  // Columns are shared, not copied
+  EXPECT_EQ(sub.GetColumn<double>("score").Chunk(0).data(),
+            df.GetColumn<double>("score").Chunk(0).data());
+
+  EXPECT_THROW(df.Select({"missing"}), std::exception);
+}
+
+TEST_F(ParquetTest, DataFrameFilterInMemory)
+{
+  auto path = temp_dir_ / "mem_filter.parquet";
+
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WriteRecord({1, "alice", 85.5});
+    writer.WriteRecord({2, "bob", 92.0});
+    writer.WriteRecord({3, "charlie", 78.5});
+    writer.Finish();
+  }
+
+  basis_rs::DataFrame df(path);
+
+  auto high = df.Filter("score", basis_rs::Gt, 80.0);
+  EXPECT_EQ(high.NumRows(), 2);
+  EXPECT_EQ(df.NumRows(), 3); // source is unchanged
+
+  auto bob = df.Filter("name", basis_rs::Eq, "bob");
+  ASSERT_EQ(bob.NumRows(), 1);
+  EXPECT_EQ(bob.GetColumn<int64_t>("id")[0], 2);
+
+  // Chained with Select, on a shared handle
+  basis_rs::SharedDataFrame shared(std::move(df));
+  auto chained = shared.Filter("id", basis_rs::Ge, int64_t{2}).Select({"id"});
+  EXPECT_EQ(chained.NumRows(), 2);
+  EXPECT_EQ(chained.NumCols(), 1);
+}
+
+// ==================== Typed Query Tests ====================
+
+// Literal types are checked against member types at compile time
+static_assert(basis_rs::kFilterLiteralMatches<double, double>);
+static_assert(!basis_rs::kFilterLiteralMatches<double, float>);
+static_assert(!basis_rs::kFilterLiteralMatches<float, double>);
+static_assert(basis_rs::kFilterLiteralMatches<int64_t, int32_t>);
+static_assert(!basis_rs::kFilterLiteralMatches<int32_t, int64_t>);
+static_assert(!basis_rs::kFilterLiteralMatches<int64_t, uint64_t>);
+static_assert(basis_rs::kFilterLiteralMatches<std::string, const char (&)[4]>);
+static_assert(!basis_rs::kFilterLiteralMatches<bool, int>);
+
+TEST_F(ParquetTest, TypedQueryCollectAs)
+{
+  auto path = temp_dir_ / "typed_query.parquet";
+
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WriteRecord({1, "alice", 85.5});
+    writer.WriteRecord({2, "bob", 92.0});
+    writer.WriteRecord({3, "charlie", 78.5});
+    writer.Finish();
+  }
+
+  auto records = basis_rs::DataFrame::Query<SimpleEntry>(path)
+                     .Where(&SimpleEntry::score, basis_rs::Gt, 80.0)
+                     .Where(&SimpleEntry::id, basis_rs::Ne, 1)
+                     .CollectAs<SimpleEntry>();
+
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(records[0].id, 2);
+  EXPECT_EQ(records[0].name, "bob");
+  EXPECT_DOUBLE_EQ(records[0].score, 92.0);
+}
+
+TEST_F(ParquetTest, TypedQueryCollectAsStreamsPlannedRowGroups)
+{
+  auto path = temp_dir_ / "typed_query_groups.parquet";
+
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WithRowGroupSize(10);
+    for (int64_t i = 0; i < 100; ++i) writer.WriteRecord({i, "r", i * 1.0});
+    writer.Finish();
+  }
+
+  basis_rs::CancellationToken token;
+  auto records = basis_rs::DataFrame::Query<SimpleEntry>(path)
+                     .Where(&SimpleEntry::id, basis_rs::Ge, int64_t{35})
+                     .Where(&SimpleEntry::id, basis_rs::Lt, int64_t{62})
+                     .WithCancellation(token)
+                     .CollectAs<SimpleEntry>();
+
+  ASSERT_EQ(records.size(), 27);
+  for (size_t i = 0; i < records.size(); ++i) {
+    EXPECT_EQ(records[i].id, 35 + static_cast<int64_t>(i));
+    EXPECT_EQ(records[i].name, "r");
+  }
+  // One batch per row group holding [35, 62); the others are never read
+  EXPECT_EQ(token.Stats().completed_batches, 4);
+}
+
+TEST_F(ParquetTest, TypedQuerySelect)
+{
+  auto path = temp_dir_ / "typed_query_select.parquet";
+
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WriteRecord({1, "alice", 85.5});
+    writer.WriteRecord({2, "bob", 92.0});
+    writer.Finish();
+  }
+
+  auto query = basis_rs::DataFrame::Query<SimpleEntry>(path)
+                   .Where(&SimpleEntry::name, basis_rs::Eq, "bob")
+                   .Select(&SimpleEntry::id, &SimpleEntry::score);
+
+  // Selected members plus the filter column, which the scan needs to evaluate
+  auto df = query.Collect();
+  EXPECT_EQ(df.NumRows(), 1);
+  EXPECT_EQ(df.NumCols(), 3);
+
+  auto records = query.CollectAs<SimpleEntry>();
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(records[0].id, 2);
+  EXPECT_DOUBLE_EQ(records[0].score, 92.0);
+  EXPECT_TRUE(records[0].name.empty()); // not selected
+
+  // Without Select(), only codec columns are read
+  auto all = basis_rs::DataFrame::Query<PartialEntry>(path).Collect();
+  EXPECT_EQ(all.NumCols(), 2);
+}
+
+// ==================== Streaming Record Tests ====================
+
+TEST_F(ParquetTest, ForEachRecordsBatches)
+{
+  auto path = temp_dir_ / "for_each_records.parquet";
+
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WithRowGroupSize(4);
+    for (int64_t i = 0; i < 10; ++i) {
+      writer.WriteRecord({i, "name_" + std::to_string(i), i * 1.5});
+    }
+    writer.Finish();
+  }
+
+  std::vector<int64_t> ids;
+  size_t max_batch = 0;
+  const SimpleEntry* buffer = nullptr;
+  bool buffer_reused = true;
+  basis_rs::DataFrame::Open(path).ForEachRecords<SimpleEntry>(
+      3, [&](std::span<const SimpleEntry> batch) {
+        if (buffer != nullptr && batch.data() != buffer) buffer_reused = false;
+        buffer = batch.data();
+        max_batch = std::max(max_batch, batch.size());
+        for (const auto& r : batch) {
+          EXPECT_EQ(r.name, "name_" + std::to_string(r.id));
+          EXPECT_DOUBLE_EQ(r.score, r.id * 1.5);
+          ids.push_back(r.id);
+        }
+      });
+
+  ASSERT_EQ(ids.size(), 10);
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(ids[i], i);
+  }
+  EXPECT_EQ(max_batch, 3);
+  EXPECT_TRUE(buffer_reused);
+}
+
+TEST_F(ParquetTest, ForEachRecordsFiltered)
+{
+  auto path = temp_dir_ / "for_each_records_filtered.parquet";
+
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WithRowGroupSize(5);
+    for (int64_t i = 0; i < 20; ++i) {
+      writer.WriteRecord({i, "n", static_cast<double>(i)});
+    }
+    writer.Finish();
+  }
+
+  // Whole row groups per callback, filter applied within each group
+  std::vector<int64_t> ids;
+  basis_rs::DataFrame::Open(path)
+      .Filter("score", basis_rs::Ge, 12.0)
+      .ForEachRecords<PartialEntry>(0, [&](std::span<const PartialEntry> batch) {
+        EXPECT_LE(batch.size(), 5);
+        for (const auto& r : batch) ids.push_back(r.id);
+      });
+
+  ASSERT_EQ(ids.size(), 8);
+  EXPECT_EQ(ids.front(), 12);
+  EXPECT_EQ(ids.back(), 19);
+}
+
+// ==================== Writer Buffer Tests ====================
+
+TEST_F(ParquetTest, ParquetWriterEmplaceAndMove)
+{
+  auto path = temp_dir_ / "writer_emplace.parquet";
+
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WithRowGroupSize(2);
+    writer.Emplace(1, "alice", 85.5);
+    EXPECT_EQ(writer.BufferSize(), 1);
+
+    SimpleEntry bob{2, std::string(64, 'b'), 92.0};
+    writer.WriteRecord(std::move(bob));
+    EXPECT_EQ(writer.BufferSize(), 0); // flushed at row_group_size
+
+    writer.Emplace(3, "charlie", 78.5);
+    writer.Finish();
+  }
+
+  basis_rs::DataFrame df(path);
+  auto records = df.ReadAllAs<SimpleEntry>();
+  ASSERT_EQ(records.size(), 3);
+  EXPECT_EQ(records[0].name, "alice");
+  EXPECT_EQ(records[1].name, std::string(64, 'b'));
+  EXPECT_EQ(records[2].id, 3);
+  EXPECT_DOUBLE_EQ(records[2].score, 78.5);
+}
+
+TEST_F(ParquetTest, ParquetWriterWriteRecordsSpan)
+{
+  auto path = temp_dir_ / "writer_span.parquet";
+
+  std::vector<SimpleEntry> entries;
+  for (int64_t i = 1; i <= 10; ++i) {
+    entries.push_back({i, "n" + std::to_string(i), i * 0.5});
+  }
+
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WithRowGroupSize(3);
+    writer.WriteRecord({0, "n0", 0.0});
+    // Tops up the buffered row group, writes two groups in place, buffers 1
+    writer.WriteRecords(std::span<const SimpleEntry>(entries).first(9));
+    EXPECT_EQ(writer.BufferSize(), 1);
+    writer.WriteRecords(std::span<const SimpleEntry>(entries).subspan(9));
+    writer.Finish();
+  }
+
+  basis_rs::DataFrame df(path);
+  auto records = df.ReadAllAs<SimpleEntry>();
+  ASSERT_EQ(records.size(), 11);
+  for (int64_t i = 0; i <= 10; ++i) {
+    EXPECT_EQ(records[i].id, i);
+    EXPECT_EQ(records[i].name, "n" + std::to_string(i));
+  }
+}
+
+TEST_F(ParquetTest, ParquetWriterWriteRecordsAfterShrinkingRowGroups)
+{
+  auto path = temp_dir_ / "writer_span_shrink.parquet";
+
+  std::vector<SimpleEntry> entries;
+  for (int64_t i = 0; i < 11; ++i) {
+    entries.push_back({i, "s", i * 1.0});
+  }
+
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WithRowGroupSize(10);
+    writer.WriteRecords(std::span<const SimpleEntry>(entries).first(5));
+    // The buffer already holds more than a row group: it is flushed first
+    // instead of absorbing the whole span into one oversized group
+    writer.WithRowGroupSize(2);
+    writer.WriteRecords(std::span<const SimpleEntry>(entries).subspan(5));
+    EXPECT_EQ(writer.BufferSize(), 0);
+    writer.Finish();
+  }
+
+  basis_rs::DataFrame df(path);
+  auto ids = df.GetColumn<int64_t>("id");
+  ASSERT_EQ(ids.size(), 11);
+  EXPECT_GE(ids.NumChunks(), 4);  // 5, then three groups of 2
+  for (size_t i = 0; i < ids.size(); ++i) {
+    EXPECT_EQ(ids[i], static_cast<int64_t>(i));
+  }
+}
+
+TEST_F(ParquetTest, ParquetWriterWriteRecordsRange)
+{
+  auto path = temp_dir_ / "writer_range.parquet";
+
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WithRowGroupSize(2);
+    std::deque<SimpleEntry> queued = {{1, "a", 1.0}, {2, "b", 2.0}, {3, "c", 3.0}};
+    writer.WriteRecords(std::move(queued));
+    writer.WriteRecords(std::views::iota(4, 6) | std::views::transform([](int i) {
+                          return SimpleEntry{i, "v", i * 1.0};
+                        }));
+    writer.Finish();
+  }
+
+  basis_rs::DataFrame df(path);
+  auto ids = df.GetColumn<int64_t>("id");
+  ASSERT_EQ(ids.size(), 5);
+  for (size_t i = 0; i < ids.size(); ++i) {
+    EXPECT_EQ(ids[i], static_cast<int64_t>(i + 1));
+  }
+}
+
+TEST_F(ParquetTest, CodecWriteAllFailureLeavesWriterUsable)
+{
+  auto path = temp_dir_ / "codec_write_failure.parquet";
+  const auto& codec = basis_rs::GetParquetCodec<SimpleEntry>();
+  auto writer = basis_rs::ffi::parquet_writer_new(path.string(), "zstd", 0);
+
+  // "id" is handed to the writer before "name" fails UTF-8 conversion
+  std::vector<SimpleEntry> bad = {{1, "\xff", 1.0}};
+  EXPECT_THROW(codec.WriteAll(*writer, bad), std::exception);
+
+  std::vector<SimpleEntry> good = {{2, "ok", 2.0}};
+  codec.WriteAll(*writer, good);
+  basis_rs::ffi::parquet_writer_write_batch(*writer);
+  basis_rs::ffi::parquet_writer_finish(std::move(writer));
+
+  basis_rs::DataFrame df(path);
+  auto records = df.ReadAllAs<SimpleEntry>();
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(records[0].id, 2);
+  EXPECT_EQ(records[0].name, "ok");
+}
+
+// ==================== Key Index Tests ====================
+
+TEST_F(ParquetTest, KeyIndexPointReads)
+{
+  auto path = temp_dir_ / "key_index.parquet";
+
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WithRowGroupSize(5);
+    for (int64_t i = 0; i < 30; ++i) {
+      writer.WriteRecord({i / 10, "row" + std::to_string(i), static_cast<double>(i)});
+    }
+    writer.Finish();
+  }
+
+  basis_rs::BuildKeyIndex(path, "id");
+  EXPECT_TRUE(std::filesystem::exists(path.string() + ".id.keyidx"));
+
+  auto one = basis_rs::DataFrame::Open(path).Filter("id", basis_rs::Eq, int64_t{1}).Collect();
+  auto one_scores = one.GetColumn<double>("score");
+  ASSERT_EQ(one_scores.size(), 10);
+  EXPECT_DOUBLE_EQ(one_scores[0], 10.0);
+  EXPECT_DOUBLE_EQ(one_scores[9], 19.0);
+
+  auto two = basis_rs::DataFrame::Open(path).FilterIn("id", {2, 0}).Collect();
+  auto two_scores = two.GetColumn<double>("score");
+  ASSERT_EQ(two_scores.size(), 20);
+  EXPECT_DOUBLE_EQ(two_scores[0], 0.0);   // file order, not key order
+  EXPECT_DOUBLE_EQ(two_scores[10], 20.0);
+
+  auto none = basis_rs::DataFrame::Open(path).Filter("id", basis_rs::Eq, int64_t{99}).Collect();
+  EXPECT_EQ(none.NumRows(), 0);
+  EXPECT_EQ(none.NumCols(), 3);
+}
+
+TEST_F(ParquetTest, KeyIndexStaleAfterRewrite)
+{
+  auto path = temp_dir_ / "key_index_stale.parquet";
+
+  auto write = [&](int64_t rows)
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    for (int64_t i = 0; i < rows; ++i) {
+      writer.WriteRecord({i % 3, "r", static_cast<double>(i)});
+    }
+    writer.Finish();
+  };
+
+  write(6);
+  basis_rs::BuildKeyIndex(path, "id");
+  write(12); // different size: the sidecar no longer applies
+
+  auto df = basis_rs::DataFrame::Open(path).Filter("id", basis_rs::Eq, int64_t{0}).Collect();
+  EXPECT_EQ(df.NumRows(), 4);
+}
+
+// ==================== Datetime Filter / Page Option Tests ====================
+
+TEST_F(ParquetTest, DateTimeFilterWindow)
+{
+  auto path = temp_dir_ / "datetime_window.parquet";
+  const absl::CivilSecond open(2025, 1, 2, 9, 30, 0);
+
+  {
+    basis_rs::ParquetWriter<TimestampEntry> writer(path);
+    writer.WithRowGroupSize(4).WithDataPageSize(1024);
+    for (int64_t i = 0; i < 10; ++i) {
+      writer.WriteRecord({i, open + i * 60});
+    }
+    writer.Finish();
+  }
+
+  const auto& tz = basis_rs::GetShanghaiTimeZone();
+  auto from = absl::FromCivil(open + 2 * 60, tz);
+  auto to = absl::FromCivil(open + 5 * 60, tz);
+
+  auto df = basis_rs::DataFrame::Open(path)
+                .Filter("timestamp", basis_rs::Ge, from)
+                .Filter("timestamp", basis_rs::Lt, to)
+                .Collect();
+  auto records = df.ReadAllAs<TimestampEntry>();
+  ASSERT_EQ(records.size(), 3);
+  EXPECT_EQ(records[0].id, 2);
+  EXPECT_EQ(records[2].timestamp, open + 4 * 60);
+
+  // Same window evaluated in memory
+  basis_rs::DataFrame all(path);
+  EXPECT_EQ(all.Filter("timestamp", basis_rs::Ge, to).NumRows(), 5);
+}
+
+TEST_F(ParquetTest, WriterWithoutStatistics)
+{
+  auto path = temp_dir_ / "no_stats.parquet";
+
+  {
+    basis_rs::ColumnarParquetWriter writer(path);
+    std::vector<int64_t> ids(1000);
+    for (size_t i = 0; i < ids.size(); ++i) ids[i] = static_cast<int64_t>(i);
+    writer.WithStatistics(false).WithDataPageSize(512);
+    writer.AddColumn("id", ids.data(), ids.size());
+    writer.WriteBatch();
+    writer.Finish();
+  }
+
+  auto df = basis_rs::DataFrame::Open(path).Filter("id", basis_rs::Ge, int64_t{990}).Collect();
+  EXPECT_EQ(df.NumRows(), 10);
+}
+
+// ==================== Sorted Row Group Planning Tests ====================
+
+TEST_F(ParquetTest, SortedRangeFilterPlanning)
+{
+  auto path = temp_dir_ / "sorted_planning.parquet";
+
+  {
+    std::vector<int64_t> ids(1000);
+    std::vector<double> values(1000);
+    for (size_t i = 0; i < ids.size(); ++i) {
+      ids[i] = static_cast<int64_t>(i);
+      values[i] = static_cast<double>(i % 10);
+    }
+    basis_rs::ColumnarParquetWriter writer(path);
+    writer.WithRowGroupSize(100);
+    writer.AddColumn("id", ids.data(), ids.size());
+    writer.AddColumn("value", values.data(), values.size());
+    writer.WriteBatch();
+    writer.Finish();
+  }
+
+  // Boundary group [100, 200) is filtered, [200, 500) is covered, [500, 600) filtered
+  auto range = basis_rs::DataFrame::Open(path)
+                   .Filter("id", basis_rs::Ge, int64_t{150})
+                   .Filter("id", basis_rs::Lt, int64_t{520})
+                   .Collect();
+  auto ids = range.GetColumn<int64_t>("id");
+  ASSERT_EQ(ids.size(), 370);
+  EXPECT_EQ(ids[0], 150);
+  EXPECT_EQ(ids[ids.size() - 1], 519);
+
+  // Other filters still apply inside covered groups
+  auto mixed = basis_rs::DataFrame::Open(path)
+                   .Filter("id", basis_rs::Ge, int64_t{200})
+                   .Filter("id", basis_rs::Lt, int64_t{400})
+                   .Filter("id", basis_rs::Ne, int64_t{300})
+                   .Filter("value", basis_rs::Eq, 0.0)
+                   .Collect();
+  EXPECT_EQ(mixed.NumRows(), 19);
+
+  auto point = basis_rs::DataFrame::Open(path).Filter("id", basis_rs::Eq, int64_t{742}).Collect();
+  ASSERT_EQ(point.NumRows(), 1);
+  EXPECT_DOUBLE_EQ(point.GetColumn<double>("value")[0], 2.0);
+
+  auto none = basis_rs::DataFrame::Open(path)
+                  .Select({"id"})
+                  .Filter("id", basis_rs::Gt, int64_t{5000})
+                  .Collect();
+  EXPECT_EQ(none.NumRows(), 0);
+  EXPECT_EQ(none.NumCols(), 1);
+}
+
+TEST_F(ParquetTest, UnsortedRangeFilterFallback)
+{
+  auto path = temp_dir_ / "unsorted_planning.parquet";
+
+  {
+    std::vector<int64_t> ids(1000);
+    for (size_t i = 0; i < ids.size(); ++i) ids[i] = static_cast<int64_t>((i * 7) % 1000);
+    basis_rs::ColumnarParquetWriter writer(path);
+    writer.WithRowGroupSize(100);
+    writer.AddColumn("id", ids.data(), ids.size());
+    writer.WriteBatch();
+    writer.Finish();
+  }
+
+  auto df = basis_rs::DataFrame::Open(path)
+                .Filter("id", basis_rs::Ge, int64_t{150})
+                .Filter("id", basis_rs::Lt, int64_t{520})
+                .Collect();
+  EXPECT_EQ(df.NumRows(), 370);
+}
+
+// ==================== Batch Query Tests ====================
+
+TEST_F(ParquetTest, BatchQueryAcrossFiles)
+{
+  std::vector<std::filesystem::path> days;
+  for (int day = 0; day < 3; ++day) {
+    days.push_back(temp_dir_ / ("batch_day_" + std::to_string(day) + ".parquet"));
+    basis_rs::ParquetWriter<SimpleEntry> writer(days.back());
+    for (int64_t i = 0; i < 20; ++i) {
+      writer.WriteRecord({i % 5, "d" + std::to_string(day), day * 100.0 + i});
+    }
+    writer.Finish();
+  }
+
+  auto by_key = basis_rs::BatchQuery(days, "id", {3, 1, 3, 42})
+                    .Select({"score"})
+                    .Collect();
+  ASSERT_EQ(by_key.size(), 3);
+
+  const auto& one = by_key.at(1);
+  EXPECT_EQ(one.NumCols(), 1);
+  auto scores = one.GetColumn<double>("score");
+  ASSERT_EQ(scores.size(), 12); // 4 rows per file, files in order
+  EXPECT_DOUBLE_EQ(scores[0], 1.0);
+  EXPECT_DOUBLE_EQ(scores[4], 101.0);
+  EXPECT_DOUBLE_EQ(scores[11], 216.0);
+
+  EXPECT_EQ(by_key.at(3).NumRows(), 12);
+  EXPECT_EQ(by_key.at(42).NumRows(), 0);
+  EXPECT_EQ(by_key.at(42).NumCols(), 1);
+}
+
+TEST_F(ParquetTest, InFilterSortedPlanningWithoutIndex)
+{
+  auto path = temp_dir_ / "in_sorted.parquet";
+  {
+    std::vector<int32_t> ids(1000);
+    std::vector<double> values(1000);
+    for (size_t i = 0; i < ids.size(); ++i) {
+      ids[i] = static_cast<int32_t>(i / 4);  // sorted, 4 rows per key
+      values[i] = static_cast<double>(i);
+    }
+    basis_rs::ColumnarParquetWriter writer(path);
+    writer.WithRowGroupSize(100);
+    writer.AddColumn("id", ids.data(), ids.size());
+    writer.AddColumn("value", values.data(), values.size());
+    writer.WriteBatch();
+    writer.Finish();
+  }
+  ASSERT_FALSE(std::filesystem::exists(path.string() + ".id.keyidx"));
+
+  // The keys lie in row groups 1-3; the others are pruned by their
+  // statistics and the IN filter applies inside the range
+  auto df = basis_rs::DataFrame::Open(path)
+                .FilterIn("id", {30, 99, 60})
+                .Collect();
+  auto values = df.GetColumn<double>("value");
+  ASSERT_EQ(values.size(), 12);
+  EXPECT_DOUBLE_EQ(values[0], 120.0);
+  EXPECT_DOUBLE_EQ(values[4], 240.0);
+  EXPECT_DOUBLE_EQ(values[11], 399.0);
+
+  auto none = basis_rs::DataFrame::Open(path).FilterIn("id", {5000, 6000}).Collect();
+  EXPECT_EQ(none.NumRows(), 0);
+
+  auto by_key = basis_rs::BatchQuery({path}, "id", {99, 0}).Collect();
+  EXPECT_EQ(by_key.at(0).NumRows(), 4);
+  EXPECT_EQ(by_key.at(99).NumRows(), 4);
+}
+
+// ==================== Incremental Rechunk Tests ====================
+
+TEST_F(ParquetTest, RechunkColumnsOnly)
+{
+  std::vector<basis_rs::DataFrame> frames;
+  for (int part = 0; part < 3; ++part) {
+    auto path = temp_dir_ / ("rechunk_part_" + std::to_string(part) + ".parquet");
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    for (int64_t i = 0; i < 10; ++i) {
+      writer.WriteRecord({part * 10 + i, "p", static_cast<double>(i)});
+    }
+    writer.Finish();
+    frames.emplace_back(path);
+  }
+  auto df = basis_rs::DataFrame::Concat(std::move(frames));
+
+  EXPECT_EQ(df.RechunkColumns({"id"}), 1);
+  EXPECT_EQ(df.GetColumn<int64_t>("id").NumChunks(), 1);
+  EXPECT_GE(df.GetColumn<double>("score").NumChunks(), 3);
+  EXPECT_EQ(df.RechunkColumns({"id"}), 0); // already contiguous
+
+  auto ids = df.GetColumn<int64_t>("id");
+  EXPECT_EQ(ids[29], 29);
+  EXPECT_THROW(df.RechunkColumns({"missing"}), std::exception);
+}
+
+TEST_F(ParquetTest, RechunkAsyncAllColumns)
+{
+  std::vector<basis_rs::DataFrame> frames;
+  for (int part = 0; part < 2; ++part) {
+    auto path = temp_dir_ / ("rechunk_async_" + std::to_string(part) + ".parquet");
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WriteRecord({part, "p", 1.0});
+    writer.Finish();
+    frames.emplace_back(path);
+  }
+  auto df = basis_rs::DataFrame::Concat(std::move(frames));
+
+  auto pending = std::move(df).RechunkAsync();
+  auto rechunked = pending.get();
+  EXPECT_EQ(rechunked.GetColumn<int64_t>("id").NumChunks(), 1);
+  EXPECT_EQ(rechunked.GetColumn<double>("score").NumChunks(), 1);
+  EXPECT_EQ(rechunked.GetStringColumn("name").size(), 2);
+}
+
+// ==================== Coroutine Awaitable Tests ====================
+
+/// Minimal eager coroutine for driving awaitables in tests. Completion (or
+/// the escaping exception) is reported through `finished`.
+struct TestTask
+{
+  struct promise_type
+  {
+    std::promise<void> done;
+
+    TestTask get_return_object() { return {done.get_future()}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() { done.set_value(); }
+    void unhandled_exception() { done.set_exception(std::current_exception()); }
+  };
+
+  std::future<void> finished;
+};
+
+TEST_F(ParquetTest, AwaitFlushOpenCollect)
+{
+  auto path = temp_dir_ / "awaitable.parquet";
+
+  auto run = [&]() -> TestTask
+  {
+    {
+      basis_rs::ParquetWriter<SimpleEntry> writer(path);
+      writer.WriteRecord({1, "a", 1.0});
+      writer.WriteRecord({2, "b", 2.0});
+      co_await writer.FlushAwait();
+      EXPECT_EQ(writer.BufferSize(), 0);
+      co_await writer.FlushAwait(); // nothing buffered: completes inline
+      writer.WriteRecord({3, "c", 3.0});
+      co_await writer.FlushAwait();
+      writer.Finish();
+    }
+
+    auto df = co_await basis_rs::DataFrame::OpenAwait(path);
+    EXPECT_EQ(df.NumRows(), 3);
+
+    auto filtered = co_await basis_rs::DataFrame::Open(path)
+                        .Filter("id", basis_rs::Ge, int64_t{2})
+                        .CollectAwait();
+    EXPECT_EQ(filtered.NumRows(), 2);
+  };
+  run().finished.get();
+}
+
+TEST_F(ParquetTest, AwaitCustomResumeAndError)
+{
+  auto path = temp_dir_ / "awaitable_resume.parquet";
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WriteRecord({1, "a", 1.0});
+    writer.Finish();
+  }
+
+  std::atomic<int> resumes{0};
+  basis_rs::ResumeFn resume = [&](std::coroutine_handle<> h)
+  {
+    ++resumes;
+    h.resume();
+  };
+
+  auto run = [&]() -> TestTask
+  {
+    auto df = co_await basis_rs::DataFrame::OpenAwait(path, resume);
+    EXPECT_EQ(df.NumRows(), 1);
+    co_await basis_rs::DataFrame::OpenAwait(temp_dir_ / "missing.parquet");
+  };
+  auto task = run();
+  EXPECT_THROW(task.finished.get(), std::exception);
+  EXPECT_EQ(resumes.load(), 1);
+}
+
+TEST_F(ParquetTest, FinishDuringFlushAwaitThrows)
+{
+  auto path = temp_dir_ / "awaitable_in_flight.parquet";
+  basis_rs::ParquetWriter<SimpleEntry> writer(path);
+
+  // Park the continuation so the flush stays in flight until we resume it
+  std::promise<std::coroutine_handle<>> parked;
+  basis_rs::ResumeFn resume = [&](std::coroutine_handle<> h)
+  { parked.set_value(h); };
+
+  auto run = [&]() -> TestTask
+  {
+    writer.WriteRecord({1, "a", 1.0});
+    writer.WriteRecord({2, "b", 2.0});
+    co_await writer.FlushAwait(resume);
+    writer.WriteRecord({3, "c", 3.0});
+    writer.Finish();
+  };
+  auto task = run();
+  auto handle = parked.get_future().get();
+
+  EXPECT_THROW(writer.Finish(), std::logic_error);
+  EXPECT_THROW(writer.Discard(), std::logic_error);
+
+  handle.resume();
+  task.finished.get();
+
+  basis_rs::DataFrame df(path);
+  EXPECT_EQ(df.NumRows(), 3);
+}
+
+// ==================== Cancellation Tests ====================
+
+TEST_F(ParquetTest, CancelledCollectThrows)
+{
+  auto path = temp_dir_ / "cancel_collect.parquet";
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WithRowGroupSize(10);
+    for (int64_t i = 0; i < 100; ++i) writer.WriteRecord({i, "c", 1.0});
+    writer.Finish();
+  }
+
+  basis_rs::CancellationToken token;
+  auto df = basis_rs::DataFrame::Open(path).WithCancellation(token).Collect();
+  EXPECT_EQ(df.NumRows(), 100);
+  EXPECT_GE(token.Stats().completed_batches, 1);
+
+  token.Cancel();
+  EXPECT_TRUE(token.IsCancelled());
+  EXPECT_THROW(basis_rs::DataFrame::Open(path)
+                   .Filter("id", basis_rs::Ge, int64_t{0})
+                   .WithCancellation(token)
+                   .Collect(),
+               basis_rs::OperationCancelled);
+
+  auto stats = token.Stats();
+  EXPECT_EQ(stats.cancelled_operations, 1);
+  EXPECT_GE(stats.skipped_batches, 1);
+}
+
+TEST_F(ParquetTest, CancelStreamingMidway)
+{
+  auto path = temp_dir_ / "cancel_stream.parquet";
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WithRowGroupSize(10);
+    for (int64_t i = 0; i < 50; ++i) writer.WriteRecord({i, "s", 1.0});
+    writer.Finish();
+  }
+
+  basis_rs::CancellationToken token;
+  size_t seen = 0;
+  EXPECT_THROW(basis_rs::DataFrame::Open(path)
+                   .WithCancellation(token)
+                   .ForEachRecords<SimpleEntry>(0,
+                                                [&](std::span<const SimpleEntry> batch)
+                                                {
+                                                  seen += batch.size();
+                                                  if (seen >= 20) token.Cancel();
+                                                }),
+               basis_rs::OperationCancelled);
+  EXPECT_EQ(seen, 20);
+  EXPECT_EQ(token.Stats().completed_batches, 2);
+  EXPECT_EQ(token.Stats().skipped_batches, 3);
+}
+
+TEST_F(ParquetTest, DeadlineCancelsCollect)
+{
+  auto path = temp_dir_ / "cancel_deadline.parquet";
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WriteRecord({1, "d", 1.0});
+    writer.Finish();
+  }
+
+  basis_rs::CancellationToken token;
+  token.CancelAt(std::chrono::steady_clock::now() - std::chrono::seconds(1));
+  EXPECT_THROW(basis_rs::DataFrame::Open(path).WithCancellation(token).Collect(),
+               basis_rs::OperationCancelled);
+}
+
+TEST_F(ParquetTest, CancelCollectMidScan)
+{
+  auto path = temp_dir_ / "cancel_mid_scan.parquet";
+  constexpr size_t kRowGroups = 400;
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WithRowGroupSize(10);
+    for (size_t i = 0; i < kRowGroups * 10; ++i) writer.WriteRecord({static_cast<int64_t>(i), "m", 1.0});
+    writer.Finish();
+  }
+
+  // Cancel from another thread as soon as the first row group is scanned
+  basis_rs::CancellationToken token;
+  std::atomic<bool> done{false};
+  std::thread canceller([token, &done]
+                        {
+    while (token.Stats().completed_batches == 0 && !done) std::this_thread::yield();
+    token.Cancel(); });
+  EXPECT_THROW(basis_rs::DataFrame::Open(path)
+                   .Select({"id"})
+                   .WithCancellation(token)
+                   .Collect(),
+               basis_rs::OperationCancelled);
+  done = true;
+  canceller.join();
+
+  auto stats = token.Stats();
+  EXPECT_GE(stats.completed_batches, 1);
+  EXPECT_LT(stats.completed_batches, kRowGroups);
+  EXPECT_EQ(stats.completed_batches + stats.skipped_batches, kRowGroups);
+  EXPECT_EQ(stats.cancelled_operations, 1);
+}
+
+TEST_F(ParquetTest, CancellableQueryKeepsRowGroupPlanning)
+{
+  auto path = temp_dir_ / "cancel_planned.parquet";
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WithRowGroupSize(10);
+    for (int64_t i = 0; i < 1000; ++i) writer.WriteRecord({i, "p", 1.0});
+    writer.Finish();
+  }
+
+  // Sorted planning: only the 3 row groups holding [500, 529] are read
+  basis_rs::CancellationToken range_token;
+  auto range = basis_rs::DataFrame::Open(path)
+                   .Filter("id", basis_rs::Ge, int64_t{500})
+                   .Filter("id", basis_rs::Lt, int64_t{530})
+                   .WithCancellation(range_token)
+                   .Collect();
+  auto ids = range.GetColumn<int64_t>("id");
+  ASSERT_EQ(ids.size(), 30);
+  for (size_t i = 0; i < ids.size(); ++i) EXPECT_EQ(ids[i], 500 + static_cast<int64_t>(i));
+  EXPECT_GE(range_token.Stats().completed_batches, 1);
+  EXPECT_LE(range_token.Stats().completed_batches, 3);
+
+  // Key index: only the row groups holding the keys are read
+  basis_rs::BuildKeyIndex(path, "id");
+  basis_rs::CancellationToken key_token;
+  auto keys = basis_rs::DataFrame::Open(path)
+                  .FilterIn("id", {742, 105})
+                  .WithCancellation(key_token)
+                  .Collect();
+  auto key_ids = keys.GetColumn<int64_t>("id");
+  ASSERT_EQ(key_ids.size(), 2);
+  EXPECT_EQ(key_ids[0], 105);
+  EXPECT_EQ(key_ids[1], 742);
+  EXPECT_LE(key_token.Stats().completed_batches, 2);
+
+  // Nothing selected: one empty window with the file's schema
+  basis_rs::CancellationToken empty_token;
+  auto empty = basis_rs::DataFrame::Open(path)
+                   .Filter("id", basis_rs::Gt, int64_t{5000})
+                   .WithCancellation(empty_token)
+                   .Collect();
+  EXPECT_EQ(empty.NumRows(), 0);
+  EXPECT_EQ(empty.NumCols(), 3);
+  EXPECT_EQ(empty_token.Stats().completed_batches, 1);
+}
+
+// ==================== Concurrent Writer Tests ====================
+
+TEST_F(ParquetTest, ConcurrentProducersWriteOneFile)
+{
+  auto path = temp_dir_ / "concurrent_writer.parquet";
+  constexpr int kProducers = 4;
+  constexpr int64_t kPerProducer = 1000;
+  {
+    basis_rs::ConcurrentParquetWriter<SimpleEntry> writer(path);
+    writer.WithRowGroupSize(100);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kProducers; ++p)
+    {
+      threads.emplace_back([&writer, p]
+                           {
+        auto producer = writer.MakeProducer();
+        for (int64_t i = 0; i < kPerProducer; ++i) {
+          producer.WriteRecord({p * kPerProducer + i, "feed", static_cast<double>(p)});
+        }
+        EXPECT_EQ(producer.BufferSize(), 0); });
+    }
+    for (auto &t : threads) t.join();
+    EXPECT_EQ(writer.NumRowGroups(), 40);
+    writer.Finish();
+    EXPECT_EQ(writer.NumRowGroups(), 40);
+  }
+
+  basis_rs::DataFrame df(path);
+  ASSERT_EQ(df.NumRows(), kProducers * kPerProducer);
+  auto records = df.ReadAllAs<SimpleEntry>();
+
+  // Each producer's rows appear in order and complete
+  std::vector<int64_t> next(kProducers);
+  for (const auto &r : records)
+  {
+    int p = static_cast<int>(r.score);
+    EXPECT_EQ(r.id, p * kPerProducer + next[p]);
+    ++next[p];
+  }
+  for (int p = 0; p < kProducers; ++p) EXPECT_EQ(next[p], kPerProducer);
+}
+
+TEST_F(ParquetTest, ConcurrentWriterFlushesPartialGroups)
+{
+  auto path = temp_dir_ / "concurrent_partial.parquet";
+  basis_rs::ConcurrentParquetWriter<SimpleEntry> writer(path);
+  writer.WithRowGroupSize(1000);
+  EXPECT_EQ(writer.NumRowGroups(), 0);
+  EXPECT_FALSE(std::filesystem::exists(path)); // counting does not open the file
+  {
+    auto producer = writer.MakeProducer();
+    producer.WriteRecord({1, "a", 1.0});
+    producer.WriteRecord({2, "b", 2.0});
+    EXPECT_THROW(writer.Finish(), std::logic_error);
+  }  // destructor flushes the partial row group
+  writer.Finish();
+  EXPECT_EQ(writer.NumRowGroups(), 1);
+  writer.Finish(); // no-op
+  EXPECT_EQ(writer.NumRowGroups(), 1);
+
+  basis_rs::DataFrame df(path);
+  EXPECT_EQ(df.NumRows(), 2);
+}
+
+TEST_F(ParquetTest, ConcurrentWriterReportsFailedFlush)
+{
+  auto path = temp_dir_ / "missing_dir" / "concurrent.parquet";
+  basis_rs::ConcurrentParquetWriter<SimpleEntry> writer(path);
+  writer.WithRowGroupSize(1000);
+  {
+    auto producer = writer.MakeProducer();
+    producer.WriteRecord({1, "a", 1.0});
+  }  // destructor flush fails and swallows the exception
+  EXPECT_THROW(writer.Finish(), std::exception);
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+// ==================== Writer Pool Tests ====================
+
+TEST_F(ParquetTest, WriterPoolManyFilesUnderBudget)
+{
+  constexpr int kFiles = 20;
+  constexpr size_t kRows = 200;
+  // Far less than the 20 files' full row groups, so the pool must flush early
+  basis_rs::WriterPool pool(2, 16 * sizeof(SimpleEntry) * kFiles / 4);
+  pool.WithRowGroupSize(50);
+
+  std::vector<basis_rs::PooledWriter<SimpleEntry>> writers;
+  for (int f = 0; f < kFiles; ++f)
+  {
+    writers.push_back(pool.Open<SimpleEntry>(temp_dir_ / ("part_" + std::to_string(f) + ".parquet")));
+  }
+  for (size_t i = 0; i < kRows; ++i)
+  {
+    for (int f = 0; f < kFiles; ++f) writers[f].WriteRecord({static_cast<int64_t>(i), "p", static_cast<double>(f)});
+  }
+  writers.clear();
+  pool.Finish();
+
+  auto stats = pool.Stats();
+  EXPECT_EQ(stats.buffered_bytes, 0);
+  EXPECT_GT(stats.budget_flushes, 0);
+  EXPECT_GE(stats.row_groups_written, kFiles * kRows / 50);
+
+  for (int f = 0; f < kFiles; ++f)
+  {
+    basis_rs::DataFrame df(temp_dir_ / ("part_" + std::to_string(f) + ".parquet"));
+    auto records = df.ReadAllAs<SimpleEntry>();
+    ASSERT_EQ(records.size(), kRows);
+    for (size_t i = 0; i < kRows; ++i)
+    {
+      EXPECT_EQ(records[i].id, static_cast<int64_t>(i));
+      EXPECT_EQ(records[i].score, f);
+    }
+  }
+}
+
+TEST_F(ParquetTest, WriterPoolCloseAndReuse)
+{
+  auto path = temp_dir_ / "pool_single.parquet";
+  basis_rs::WriterPool pool(1);
+  auto writer = pool.Open<SimpleEntry>(path);
+  writer.WriteRecord({1, "a", 1.0});
+  EXPECT_EQ(writer.BufferSize(), 1);
+  writer.Close();
+  writer.Close();  // no-op
+  pool.Finish();
+  EXPECT_EQ(basis_rs::DataFrame(path).NumRows(), 1);
+
+  // The pool stays usable after Finish()
+  auto second = pool.Open<SimpleEntry>(temp_dir_ / "pool_second.parquet");
+  second.WriteRecords(std::vector<SimpleEntry>{{2, "b", 2.0}, {3, "c", 3.0}});
+  pool.Finish();
+  EXPECT_THROW(second.WriteRecord({4, "d", 4.0}), std::logic_error);
+  EXPECT_EQ(basis_rs::DataFrame(temp_dir_ / "pool_second.parquet").NumRows(), 2);
+}
+
+TEST_F(ParquetTest, WriterPoolHandlesOnManyThreads)
+{
+  constexpr int kThreads = 4;
+  constexpr int kFilesPerThread = 5;
+  constexpr int64_t kRows = 10000;  // Several 4096-record blocks per file
+  basis_rs::WriterPool pool(2);
+  pool.WithRowGroupSize(3000);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t)
+  {
+    threads.emplace_back([&, t]
+                         {
+      std::vector<basis_rs::PooledWriter<SimpleEntry>> writers;
+      for (int f = 0; f < kFilesPerThread; ++f) {
+        auto name = "pool_mt_" + std::to_string(t) + "_" + std::to_string(f) + ".parquet";
+        writers.push_back(pool.Open<SimpleEntry>(temp_dir_ / name));
+      }
+      for (int64_t i = 0; i < kRows; ++i) {
+        for (auto &w : writers) w.WriteRecord({i, "m", static_cast<double>(t)});
+      }
+      // Staged records count as buffered and are written on close
+      EXPECT_EQ(writers[0].BufferSize(), kRows % 3000); });
+  }
+  for (auto &t : threads) t.join();
+  pool.Finish();
+  EXPECT_EQ(pool.Stats().buffered_bytes, 0);
+
+  for (int t = 0; t < kThreads; ++t)
+  {
+    for (int f = 0; f < kFilesPerThread; ++f)
+    {
+      auto name = "pool_mt_" + std::to_string(t) + "_" + std::to_string(f) + ".parquet";
+      auto ids = basis_rs::DataFrame(temp_dir_ / name).GetColumn<int64_t>("id");
+      ASSERT_EQ(ids.size(), kRows);
+      for (int64_t i = 0; i < kRows; ++i) ASSERT_EQ(ids[i], i);
+    }
+  }
+}
+
+// ==================== Ingest Ring Tests ====================
+
+TEST_F(ParquetTest, IngestRingConcurrentProducers)
+{
+  auto path = temp_dir_ / "ingest_ring.parquet";
+  constexpr int kProducers = 4;
+  constexpr int64_t kPerProducer = 5000;
+  basis_rs::IngestRing<int64_t, int32_t, double> ring({"seq", "producer", "price"}, 256, 4);
+
+  basis_rs::ColumnarParquetWriter writer(path);
+  std::atomic<int> running{kProducers};
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p)
+  {
+    producers.emplace_back([&ring, &running, p]
+                           {
+      for (int64_t i = 0; i < kPerProducer; ++i) ring.Push(i, p, 1.5);
+      running.fetch_sub(1); });
+  }
+  size_t written = 0;
+  while (running.load() > 0) written += ring.Drain(writer);
+  for (auto &t : producers) t.join();
+  written += ring.Drain(writer, true);
+  writer.Finish();
+
+  EXPECT_EQ(written, kProducers * kPerProducer);
+  auto stats = ring.Stats();
+  EXPECT_EQ(stats.rows_written, written);
+  EXPECT_EQ(stats.dropped, 0);
+
+  basis_rs::DataFrame df(path);
+  ASSERT_EQ(df.NumRows(), kProducers * kPerProducer);
+  auto seq = df.GetColumn<int64_t>("seq");
+  auto producer = df.GetColumn<int32_t>("producer");
+  std::vector<int64_t> next(kProducers);
+  for (size_t i = 0; i < df.NumRows(); ++i)
+  {
+    EXPECT_EQ(seq[i], next[producer[i]]++);
+  }
+}
+
+TEST_F(ParquetTest, IngestRingDropsWhenFull)
+{
+  auto path = temp_dir_ / "ingest_drop.parquet";
+  basis_rs::IngestRing<int64_t, double> ring({"ts", "price"}, 8, 2);
+  ring.AsDateTime("ts");
+  EXPECT_THROW(ring.AsDateTime("price"), std::invalid_argument);
+
+  for (int64_t i = 0; i < 16; ++i) EXPECT_TRUE(ring.TryPush(1700000000000 + i, 1.0));
+  EXPECT_FALSE(ring.TryPush(0, 0.0));
+  EXPECT_EQ(ring.Stats().dropped, 1);
+
+  basis_rs::ColumnarParquetWriter writer(path);
+  EXPECT_EQ(ring.Drain(writer), 16);
+  EXPECT_TRUE(ring.TryPush(1700000000016, 2.0));
+  EXPECT_EQ(ring.Drain(writer), 0);
+  EXPECT_EQ(ring.Drain(writer, true), 1);
+  writer.Finish();
+
+  auto stats = ring.Stats();
+  EXPECT_EQ(stats.segments_written, 3);
+  EXPECT_EQ(stats.rows_written, 17);
+  EXPECT_EQ(basis_rs::DataFrame(path).NumRows(), 17);
+}
+
+// ==================== Converting Column Access Tests ====================
+
+// Same column names as NumericEntry, wider member types
+struct WideNumericEntry
+{
+  int64_t i32_val;
+  double i64_val;
+  double f32_val;
+  float f64_val;
+};
+
+template <>
+inline const basis_rs::ParquetCodec<WideNumericEntry> &basis_rs::GetParquetCodec()
+{
+  static basis_rs::ParquetCodec<WideNumericEntry> codec = []()
+  {
+    basis_rs::ParquetCodec<WideNumericEntry> c;
+    c.Add("i32_val", &WideNumericEntry::i32_val);
+    c.Add("i64_val", &WideNumericEntry::i64_val);
+    c.Add("f32_val", &WideNumericEntry::f32_val);
+    c.Add("f64_val", &WideNumericEntry::f64_val);
+    return c;
+  }();
+  return codec;
+}
+
+TEST_F(ParquetTest, GetColumnAsConverts)
+{
+  auto path = temp_dir_ / "column_as.parquet";
+  {
+    basis_rs::ParquetWriter<NumericEntry> writer(path);
+    writer.WithRowGroupSize(3);
+    for (int32_t i = 0; i < 10; ++i)
+    {
+      writer.WriteRecord({i, int64_t{i} * 1000000000, i + 0.5f, i * 0.25});
+    }
+    writer.Finish();
+  }
+
+  basis_rs::DataFrame df(path);
+  auto same = df.GetColumnAs<int64_t>("i64_val");
+  EXPECT_FALSE(same.OwnsData());
+  EXPECT_EQ(same.NumChunks(), df.GetColumn<int64_t>("i64_val").NumChunks());
+
+  auto widened = df.GetColumnAs<int64_t>("i32_val");
+  auto as_double = df.GetColumnAs<double>("f32_val");
+  EXPECT_TRUE(widened.OwnsData());
+  EXPECT_EQ(widened.NumChunks(), 1);
+  ASSERT_EQ(widened.size(), 10);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    EXPECT_EQ(widened[i], static_cast<int64_t>(i));
+    EXPECT_DOUBLE_EQ(as_double[i], i + 0.5);
+  }
+
+  // Narrowing is range-checked; float to integer is rejected
+  EXPECT_EQ(df.Filter("i64_val", basis_rs::Lt, int64_t{3000000000}).GetColumnAs<int32_t>("i64_val")[2],
+            2000000000);
+  EXPECT_THROW(df.GetColumnAs<int32_t>("i64_val"), std::out_of_range);
+  EXPECT_THROW(df.GetColumnAs<int64_t>("f64_val"), std::invalid_argument);
+
+  // The codec converts member types automatically
+  auto wide = df.ReadAllAs<WideNumericEntry>();
+  ASSERT_EQ(wide.size(), 10);
+  EXPECT_EQ(wide[7].i32_val, 7);
+  EXPECT_DOUBLE_EQ(wide[7].i64_val, 7e9);
+  EXPECT_DOUBLE_EQ(wide[7].f32_val, 7.5);
+  EXPECT_FLOAT_EQ(wide[7].f64_val, 1.75f);
+}
+
+TEST_F(ParquetTest, GetColumnAsDateTime)
+{
+  auto path = temp_dir_ / "column_as_datetime.parquet";
+  {
+    basis_rs::ParquetWriter<TimestampEntry> writer(path);
+    writer.WriteRecord({1, absl::CivilSecond(2024, 1, 2, 9, 30, 0)});
+    writer.WriteRecord({2, absl::CivilSecond(2024, 1, 2, 15, 0, 0)});
+    writer.Finish();
+  }
+
+  basis_rs::DataFrame df(path);
+  auto ms = df.GetColumnAs<int64_t>("timestamp");
+  auto raw = basis_rs::GetDateTimeColumn(df, "timestamp");
+  EXPECT_FALSE(ms.OwnsData());
+  EXPECT_EQ(ms[1], raw[1]);
+  EXPECT_DOUBLE_EQ(df.GetColumnAs<double>("timestamp")[0], static_cast<double>(raw[0]));
+  EXPECT_THROW(df.GetColumnAs<double>("nonexistent"), std::exception);
+
+  // Unit scaling floors: pre-epoch microseconds round to the earlier millisecond
+  std::vector<int64_t> us = {-1500, -1000, -1, 0, 999, 1500};
+  basis_rs::ColumnAccessor<int64_t> us_col;
+  us_col.AddChunk(us.data(), us.size());
+  auto as_ms = basis_rs::detail::ConvertColumn<int64_t>(us_col, 1000);
+  std::vector<int64_t> expected = {-2, -1, -1, 0, 0, 1};
+  EXPECT_EQ(std::vector<int64_t>(as_ms.begin(), as_ms.end()), expected);
+  auto as_i32 = basis_rs::detail::ConvertColumn<int32_t>(us_col, 1000);
+  EXPECT_EQ(as_i32[0], -2);
+}
+
+// ==================== String Interning Tests ====================
+
+TEST_F(ParquetTest, InternedColumnSharedAcrossFiles)
+{
+  auto day1 = temp_dir_ / "intern_day1.parquet";
+  auto day2 = temp_dir_ / "intern_day2.parquet";
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(day1);
+    writer.WriteRecords(std::vector<SimpleEntry>{
+        {1, "AAPL", 1.0}, {2, "MSFT", 1.0}, {3, "AAPL", 1.0}, {4, "GOOG", 1.0}});
+    writer.Finish();
+  }
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(day2);
+    writer.WriteRecords(std::vector<SimpleEntry>{
+        {5, "TSLA", 1.0}, {6, "GOOG", 1.0}, {7, "AAPL", 1.0}});
+    writer.Finish();
+  }
+
+  basis_rs::SymbolTable symbols;
+  auto ids1 = basis_rs::DataFrame(day1).GetInternedColumn("name", symbols);
+  ASSERT_EQ(ids1.size(), 4);
+  EXPECT_EQ(ids1[0], 0);
+  EXPECT_EQ(ids1[1], 1);
+  EXPECT_EQ(ids1[2], 0);
+  EXPECT_EQ(ids1[3], 2);
+  EXPECT_EQ(symbols.size(), 3);
+
+  // The accessor owns its IDs; the DataFrame is already gone
+  auto ids2 = basis_rs::DataFrame(day2).GetInternedColumn("name", symbols);
+  ASSERT_EQ(ids2.size(), 3);
+  EXPECT_EQ(ids2[0], 3);
+  EXPECT_EQ(ids2[1], *symbols.Find("GOOG"));
+  EXPECT_EQ(ids2[2], *symbols.Find("AAPL"));
+  EXPECT_EQ(symbols.Name(ids2[0]), "TSLA");
+  EXPECT_FALSE(symbols.Find("IBM").has_value());
+  EXPECT_THROW(symbols.Name(100), std::out_of_range);
+}
+
+// ==================== Group By Tests ====================
+
+TEST_F(ParquetTest, GroupByMatchesSerialAggregation)
+{
+  auto path = temp_dir_ / "group_by.parquet";
+  constexpr size_t kRows = 200000;
+  std::vector<int64_t> ids(kRows);
+  std::vector<double> prices(kRows);
+  std::vector<int32_t> seqs(kRows);
+  for (size_t i = 0; i < kRows; ++i)
+  {
+    ids[i] = static_cast<int64_t>((i * 7919) % 100);
+    prices[i] = static_cast<double>(i % 1000) * 0.5;
+    seqs[i] = static_cast<int32_t>(i);
+  }
+  {
+    basis_rs::ColumnarParquetWriter writer(path);
+    // Two batches, so the accessors have more than one chunk
+    size_t half = kRows / 2;
+    writer.AddColumn("id", ids.data(), half);
+    writer.AddColumn("price", prices.data(), half);
+    writer.AddColumn("seq", seqs.data(), half);
+    writer.WriteBatch();
+    writer.AddColumn("id", ids.data() + half, kRows - half);
+    writer.AddColumn("price", prices.data() + half, kRows - half);
+    writer.AddColumn("seq", seqs.data() + half, kRows - half);
+    writer.Finish();
+  }
+
+  // Order-dependent state: `ordered` stays true only if rows arrive in order
+  struct State
+  {
+    double sum = 0;
+    size_t count = 0;
+    int32_t last_seq = -1;
+    bool ordered = true;
+  };
+  auto fold = [](State& s, double price, int32_t seq) {
+    s.sum += price;
+    ++s.count;
+    s.ordered = s.ordered && seq > s.last_seq;
+    s.last_seq = seq;
+  };
+
+  std::map<int64_t, State> expected;
+  for (size_t i = 0; i < kRows; ++i)
+  {
+    fold(expected[ids[i]], prices[i], seqs[i]);
+  }
+
+  basis_rs::DataFrame df(path);
+  auto id_col = df.GetColumn<int64_t>("id");
+  auto values =
+      std::tuple(df.GetColumn<double>("price"), df.GetColumn<int32_t>("seq"));
+  for (size_t threads : {1, 4})
+  {
+    auto groups = basis_rs::GroupBy(id_col).WithThreads(threads).Aggregate<State>(
+        values, fold);
+    ASSERT_EQ(groups.size(), expected.size());
+    auto it = expected.begin();
+    for (const auto& [key, state] : groups)
+    {
+      EXPECT_EQ(key, it->first);
+      EXPECT_DOUBLE_EQ(state.sum, it->second.sum);
+      EXPECT_EQ(state.count, it->second.count);
+      EXPECT_EQ(state.last_seq, it->second.last_seq);
+      EXPECT_TRUE(state.ordered);
+      ++it;
+    }
+  }
+
+  basis_rs::ColumnAccessor<double> short_col;
+  short_col.AddChunk(prices.data(), 10);
+  EXPECT_THROW(basis_rs::GroupBy(id_col).Aggregate<State>(
+                   std::tuple(short_col), [](State&, double) {}),
+               std::invalid_argument);
+}
+
+// ==================== ArgSort / Take Tests ====================
+
+TEST_F(ParquetTest, ArgSortMatchesStableSort)
+{
+  auto path = temp_dir_ / "argsort.parquet";
+  constexpr size_t kRows = 150000;
+  std::vector<int32_t> ids(kRows);
+  std::vector<int64_t> ts(kRows);
+  std::vector<double> px(kRows);
+  for (size_t i = 0; i < kRows; ++i)
+  {
+    ids[i] = static_cast<int32_t>((i * 7919) % 300) - 150;
+    ts[i] = 1735776000000 + static_cast<int64_t>((i * 104729) % 86400000);
+    px[i] = static_cast<double>(static_cast<int64_t>(i % 2001) - 1000) / 8.0;
+  }
+  px[10] = std::nan("");
+  px[20] = -0.0;
+  {
+    basis_rs::ColumnarParquetWriter writer(path);
+    size_t half = kRows / 2;
+    writer.AddColumn("id", ids.data(), half);
+    writer.AddDateTimeColumn("ts", ts.data(), half);
+    writer.AddColumn("px", px.data(), half);
+    writer.WriteBatch();
+    writer.AddColumn("id", ids.data() + half, kRows - half);
+    writer.AddDateTimeColumn("ts", ts.data() + half, kRows - half);
+    writer.AddColumn("px", px.data() + half, kRows - half);
+    writer.Finish();
+  }
+
+  basis_rs::DataFrame df(path);
+  auto id_col = df.GetColumn<int32_t>("id");
+  auto ts_col = df.GetColumnAs<int64_t>("ts");
+  auto px_col = df.GetColumn<double>("px");
+
+  // (id, ts): ties on both keys keep row order
+  std::vector<uint32_t> expected(kRows);
+  std::iota(expected.begin(), expected.end(), 0u);
+  std::stable_sort(expected.begin(), expected.end(), [&](uint32_t a, uint32_t b) {
+    return std::tie(ids[a], ts[a]) < std::tie(ids[b], ts[b]);
+  });
+  for (size_t threads : {1, 4})
+  {
+    auto order = basis_rs::ArgSort({.threads = threads}, id_col, ts_col);
+    EXPECT_EQ(order, expected);
+  }
+
+  // Descending floats: NaN last, -0.0 ties with 0.0
+  auto order = basis_rs::ArgSort({.order = basis_rs::SortOrder::kDescending},
+                                 px_col);
+  ASSERT_EQ(order.size(), kRows);
+  EXPECT_EQ(order.back(), 10u);
+  for (size_t i = 1; i + 1 < kRows; ++i)
+  {
+    ASSERT_GE(px[order[i - 1]], px[order[i]]);
+    if (px[order[i - 1]] == px[order[i]])
+    {
+      ASSERT_LT(order[i - 1], order[i]);
+    }
+  }
+
+  basis_rs::ColumnAccessor<double> short_col;
+  short_col.AddChunk(px.data(), 10);
+  EXPECT_THROW(basis_rs::ArgSort(id_col, short_col), std::invalid_argument);
+}
+
+TEST_F(ParquetTest, TakeMaterializesSortedRows)
+{
+  auto path = temp_dir_ / "take.parquet";
+  {
+    basis_rs::ParquetWriter<SimpleEntry> writer(path);
+    writer.WriteRecords(std::vector<SimpleEntry>{
+        {3, "c", 3.5}, {1, "a", 1.5}, {2, "b", 2.5}, {1, "a2", 0.5}});
+    writer.Finish();
+  }
+
+  basis_rs::DataFrame df(path);
+  auto order = basis_rs::ArgSort(df.GetColumn<int64_t>("id"));
+  EXPECT_EQ(order, (std::vector<uint32_t>{1, 3, 2, 0}));
+
+  auto sorted = df.Take(order);
+  ASSERT_EQ(sorted.NumRows(), 4);
+  EXPECT_EQ(sorted.GetStringColumn("name"),
+            (std::vector<std::string>{"a", "a2", "b", "c"}));
+  EXPECT_EQ(df.GetColumn<int64_t>("id")[0], 3);  // Source unchanged
+
+  basis_rs::ColumnAccessor<double> values;
+  {
+    basis_rs::DataFrame scoped(path);
+    values = basis_rs::Take(scoped.GetColumn<double>("score"), order);
+  }
+  // The accessor owns its values; the DataFrame is already gone
+  ASSERT_TRUE(values.OwnsData());
+  EXPECT_EQ((std::vector<double>(values.begin(), values.end())),
+            (std::vector<double>{1.5, 0.5, 2.5, 3.5}));
+
+  std::vector<uint32_t> bad = {0, 4};
+  EXPECT_THROW(df.Take(bad), std::exception);
+  EXPECT_THROW(basis_rs::Take(df.GetColumn<double>("score"), bad),
+               std::out_of_range);
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+// This header should be included from parquet.hpp. Do not include this header
+// directly. await_resume() members returning DataFrame are defined in
+// parquet.hpp once DataFrame is complete.
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <utility>
+
+#include "cxx_bridge.rs.h"
+#include "task_callback.hpp"
+
+namespace basis_rs {
+
+// Forward declarations
+class DataFrame;
+
+/// Schedules the continuation of a coroutine suspended on a basis_rs
+/// awaitable.
+///
+/// The awaited operation runs on the Polars thread pool; no thread is
+/// dedicated to it while it is in flight. When it finishes, the pool thread
+/// calls the ResumeFn with the suspended coroutine. An empty ResumeFn resumes
+/// the coroutine inline on that pool thread. Executors that pin coroutines to
+/// their own threads should pass a function that posts the handle instead:
+///
+///   basis_rs::ResumeFn on_io = [&](std::coroutine_handle<> h) {
+///     asio::post(io_context, h);
+///   };
+///   auto df = co_await DataFrame::OpenAwait("ticks.parquet", on_io);
+///
+/// Continuations resumed inline should hand long work back to their
+/// executor rather than occupy the Polars pool thread.
+///
+/// The ResumeFn, and a coroutine resumed inline, run under a Rust frame and
+/// must not throw: an exception escaping either terminates the process.
+/// Coroutine types whose unhandled_exception() rethrows should be resumed
+/// through a ResumeFn that posts them to an executor.
+using ResumeFn = std::function<void(std::coroutine_handle<>)>;
+
+namespace detail {
+
+/// Common part of the awaitables: owns the Rust task and resumes the
+/// awaiting coroutine from the task's completion callback.
+class TaskAwaiter : private ffi::TaskCallback {
+ public:
+  bool await_ready() const noexcept { return false; }
+
+ protected:
+  explicit TaskAwaiter(ResumeFn resume)
+      : ffi::TaskCallback{&OnComplete},
+        task_(ffi::parquet_task_new()),
+        resume_(std::move(resume)) {}
+
+  /// Awaiter that is ready immediately and never starts a task.
+  TaskAwaiter(ResumeFn resume, std::nullopt_t)
+      : ffi::TaskCallback{&OnComplete}, resume_(std::move(resume)) {}
+
+  TaskAwaiter(TaskAwaiter&&) = default;
+
+  /// Record the suspended coroutine and return the callback context for a
+  /// parquet_task_* call. The awaiter lives in the coroutine frame until
+  /// resumption, so its address is stable for the duration of the task.
+  size_t Suspend(std::coroutine_handle<> handle) {
+    handle_ = handle;
+    return reinterpret_cast<size_t>(static_cast<ffi::TaskCallback*>(this));
+  }
+
+  ffi::ParquetTask& Task() { return **task_; }
+
+  std::optional<rust::Box<ffi::ParquetTask>> task_;
+
+ private:
+  static void OnComplete(ffi::TaskCallback* callback) noexcept {
+    // Called from a Rust pool thread through parquet_task_complete, which
+    // has no error channel: unwinding into the Rust frame is undefined, so
+    // an exception from the ResumeFn or the resumed coroutine terminates
+    // here instead (see ResumeFn).
+    try {
+      auto* self = static_cast<TaskAwaiter*>(callback);
+      // The coroutine may destroy this awaiter as soon as it is resumed
+      auto handle = self->handle_;
+      auto resume = std::move(self->resume_);
+      if (resume) {
+        resume(handle);
+      } else {
+        handle.resume();
+      }
+    } catch (...) {
+      std::terminate();
+    }
+  }
+
+  ResumeFn resume_;
+  std::coroutine_handle<> handle_;
+};
+
+}  // namespace detail
+
+/// Awaitable returned by DataFrame::OpenAwait().
+class OpenAwaitable : public detail::TaskAwaiter {
+ public:
+  OpenAwaitable(std::filesystem::path path, ResumeFn resume)
+      : TaskAwaiter(std::move(resume)), path_(std::move(path)) {}
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    ffi::parquet_task_open(Task(), path_.string(), Suspend(handle));
+  }
+
+  /// Throws rust::Error if the file could not be read.
+  DataFrame await_resume();
+
+ private:
+  std::filesystem::path path_;
+};
+
+/// Awaitable returned by DataFrameBuilder::CollectAwait().
+class CollectAwaitable : public detail::TaskAwaiter {
+ public:
+  CollectAwaitable(rust::Box<ffi::ParquetQuery> query, ResumeFn resume)
+      : TaskAwaiter(std::move(resume)), query_(std::move(query)) {}
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    ffi::parquet_task_collect(Task(), std::move(*query_), Suspend(handle));
+  }
+
+  /// Throws rust::Error if the query failed.
+  DataFrame await_resume();
+
+ private:
+  std::optional<rust::Box<ffi::ParquetQuery>> query_;
+};
+
+/// Awaitable returned by ParquetWriter<T>::FlushAwait(). Ready immediately
+/// when there was nothing to flush.
+class FlushAwaitable : public detail::TaskAwaiter {
+ public:
+  /// Nothing to flush: no task is started.
+  explicit FlushAwaitable(ResumeFn resume)
+      : TaskAwaiter(std::move(resume), std::nullopt) {}
+
+  /// The writer's state moves into the task when it starts and is put back
+  /// before the coroutine resumes; `in_flight` is set in between.
+  FlushAwaitable(ffi::ParquetWriter& writer, bool& in_flight, ResumeFn resume)
+      : TaskAwaiter(std::move(resume)),
+        writer_(&writer),
+        in_flight_(&in_flight) {}
+
+  bool await_ready() const noexcept { return writer_ == nullptr; }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    // Set before the call: the task may resume the coroutine before it
+    // returns
+    *in_flight_ = true;
+    ffi::parquet_task_write_batch(Task(), *writer_, Suspend(handle));
+  }
+
+  /// Throws rust::Error if the write failed.
+  void await_resume() {
+    if (writer_ == nullptr) return;
+    ffi::parquet_task_restore_writer(Task(), *writer_);
+    *in_flight_ = false;
+    ffi::parquet_task_check(Task());
+  }
+
+ private:
+  ffi::ParquetWriter* writer_ = nullptr;
+  bool* in_flight_ = nullptr;
+};
+
+}  // namespace basis_rs
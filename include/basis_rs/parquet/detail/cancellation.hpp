@@ -0,0 +1,100 @@
+#pragma once
+
+// This header should be included from parquet.hpp.
+// Do not include this header directly.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "cxx_bridge.rs.h"
+
+namespace basis_rs {
+
+/// Thrown by Collect(), ForEachRecords() and CollectAwait() when the
+/// query's CancellationToken was cancelled or its deadline passed.
+class OperationCancelled : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+/// Work accounting of a token: completed_batches, skipped_batches (work not
+/// done because of cancellation) and cancelled_operations.
+using CancellationStats = ffi::CancelStats;
+
+/// Cooperative cancellation for queries.
+///
+/// Copies share state, so one token can be handed to many queries and
+/// cancelled from any thread. Attached work checks the token between batches:
+/// a streaming batch, or a window of row groups (one per pool thread) for a
+/// collect. It stops at the next boundary and releases its CPU and I/O;
+/// Polars is not interrupted inside a batch.
+///
+/// Example:
+///   basis_rs::CancellationToken token;
+///   token.CancelAfter(std::chrono::seconds(30));
+///   auto df = DataFrame::Open("month.parquet")
+///                 .Filter("price", Gt, 100.0)
+///                 .WithCancellation(token)
+///                 .Collect();  // throws OperationCancelled after 30s
+///   // from another thread: token.Cancel();
+class CancellationToken {
+ public:
+  CancellationToken()
+      : token_(std::make_shared<rust::Box<ffi::ParquetCancelToken>>(
+            ffi::parquet_cancel_token_new())) {}
+
+  /// Cancel all operations the token is attached to.
+  void Cancel() const { ffi::parquet_cancel_token_cancel(**token_); }
+
+  /// Cancel automatically once `timeout` has elapsed from now.
+  template <typename Rep, typename Period>
+  void CancelAfter(std::chrono::duration<Rep, Period> timeout) const {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(timeout);
+    ffi::parquet_cancel_token_set_timeout(
+        **token_, static_cast<uint64_t>(std::max<int64_t>(0, us.count())));
+  }
+
+  /// Cancel automatically at `deadline`.
+  void CancelAt(std::chrono::steady_clock::time_point deadline) const {
+    CancelAfter(deadline - std::chrono::steady_clock::now());
+  }
+
+  /// True once Cancel() was called or the deadline passed.
+  bool IsCancelled() const {
+    return ffi::parquet_cancel_token_is_cancelled(**token_);
+  }
+
+  CancellationStats Stats() const {
+    return ffi::parquet_cancel_token_stats(**token_);
+  }
+
+  /// Access underlying FFI handle (for advanced use)
+  const ffi::ParquetCancelToken& Handle() const { return **token_; }
+
+ private:
+  std::shared_ptr<rust::Box<ffi::ParquetCancelToken>> token_;
+};
+
+namespace detail {
+
+/// Run fn(), translating a Rust cancellation error into OperationCancelled.
+template <typename Fn>
+decltype(auto) TranslateCancellation(Fn&& fn) {
+  try {
+    return std::forward<Fn>(fn)();
+  } catch (const rust::Error& e) {
+    if (std::string_view(e.what()).starts_with("Operation cancelled")) {
+      throw OperationCancelled(e.what());
+    }
+    throw;
+  }
+}
+
+}  // namespace detail
+
+}  // namespace basis_rs
@@ -3,9 +3,12 @@
 // This header should be included from parquet.hpp after DataFrame is defined.
 // Do not include this header directly.
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <functional>
+#include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -16,16 +19,30 @@
 
 namespace basis_rs {
 
-// Forward declaration - DataFrame is defined in parquet.hpp before this header is included
+// Forward declarations - defined in parquet.hpp before this header is included
 class DataFrame;
+class DataFrameView;
+
+/// Bytes of records transposed per block between columnar and row layout.
+inline constexpr size_t kTransposeBlockBytes = 64 * 1024;
+
+/// Upper bound on the column buffers a writer gathers before handing them
+/// to Rust. Columns are gathered in groups of at most this many bytes (or
+/// one column, if larger), so writing adds at most one group on top of the
+/// records instead of a full columnar copy of the batch.
+inline constexpr size_t kWriteGroupBytes = 16 * 1024 * 1024;
 
 /// Codec for mapping between Parquet columns and C++ struct members.
 /// Used by DataFrame::ReadAllAs<T> and ParquetWriter.
 template <typename RecordType>
 class ParquetCodec {
  public:
-  using ReaderFromDf =
-      std::function<void(const DataFrame&, std::vector<RecordType>&)>;
+  /// Reader bound to one DataFrame: copies rows [begin, begin + n) of its
+  /// column into records[0, n).
+  using BoundReader =
+      std::function<void(size_t begin, size_t n, RecordType* records)>;
+  /// Resolves a column of a DataFrame once (chunk pointers, string decode).
+  using ReaderFromDf = std::function<BoundReader(const DataFrameView&)>;
 
   ParquetCodec() = default;
 
@@ -46,82 +63,143 @@ class ParquetCodec {
     // Store reader lambda for zero-copy API
     if constexpr (std::is_same_v<T, std::string>) {
       // String columns need special handling (allocation required)
-      df_readers_.push_back(
-          [name, accessor](const DataFrame& df,
-                           std::vector<RecordType>& records) {
-            auto strings = df.GetStringColumn(name);
-            for (size_t i = 0; i < strings.size() && i < records.size(); ++i) {
-              records[i].*accessor = std::move(strings[i]);
-            }
-          });
+      df_readers_.push_back([name, accessor](const DataFrameView& df) {
+        auto strings =
+            std::make_shared<std::vector<std::string>>(df.GetStringColumn(name));
+        return BoundReader(
+            [strings, accessor](size_t begin, size_t n, RecordType* records) {
+              size_t end = std::min(begin + n, strings->size());
+              for (size_t row = begin; row < end; ++row) {
+                records[row - begin].*accessor = std::move((*strings)[row]);
+              }
+            });
+      });
     } else if constexpr (std::is_same_v<T, bool>) {
       // Bool columns are bit-packed in Arrow, cannot zero-copy.
-      df_readers_.push_back(
-          [name, accessor](const DataFrame& df,
-                           std::vector<RecordType>& records) {
-            auto rust_vec = ffi::parquet_df_get_bool_column(df.Handle(), name);
-            for (size_t i = 0; i < rust_vec.size() && i < records.size(); ++i) {
-              records[i].*accessor = rust_vec[i];
-            }
-          });
-    } else if constexpr (AbseilCivilTime<T>) {
-      // AbseilCivilTime columns use DateTime storage (int64 milliseconds)
-      df_readers_.push_back(
-          [name, accessor](const DataFrame& df,
-                           std::vector<RecordType>& records) {
-            auto chunks = ffi::parquet_df_get_datetime_chunks(df.Handle(), name);
-            constexpr absl::Time baseline{};
-            size_t row = 0;
-            for (const auto& chunk : chunks) {
-              const int64_t* ptr = reinterpret_cast<const int64_t*>(chunk.ptr);
-              for (size_t i = 0; i < chunk.len && row < records.size(); ++i) {
-                std::chrono::milliseconds time(ptr[i]);
-                absl::Time absl_time = baseline + absl::FromChrono(time);
-                records[row++].*accessor =
-                    T{absl::ToCivilSecond(absl_time, GetShanghaiTimeZone())};
+      df_readers_.push_back([name, accessor](const DataFrameView& df) {
+        auto values = std::make_shared<rust::Vec<bool>>(
+            ffi::parquet_df_get_bool_column(df.Handle(), name));
+        return BoundReader(
+            [values, accessor](size_t begin, size_t n, RecordType* records) {
+              size_t end = std::min(begin + n, values->size());
+              for (size_t row = begin; row < end; ++row) {
+                records[row - begin].*accessor = (*values)[row];
               }
-            }
-          });
+            });
+      });
+    } else if constexpr (AbseilCivilTime<T>) {
+      // AbseilCivilTime columns use DateTime storage (int64 milliseconds,
+      // scaled from the stored unit if it differs)
+      df_readers_.push_back([name, accessor](const DataFrameView& df) {
+        auto col = df.template GetColumnAs<int64_t>(name);
+        return BoundReader(
+            [col, accessor](size_t begin, size_t n, RecordType* records) {
+              constexpr absl::Time baseline{};
+              col.VisitRange(begin, n, [&](const int64_t* ptr, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                  std::chrono::milliseconds time(ptr[i]);
+                  absl::Time absl_time = baseline + absl::FromChrono(time);
+                  (records++)->*accessor =
+                      T{absl::ToCivilSecond(absl_time, GetShanghaiTimeZone())};
+                }
+              });
+            });
+      });
     } else {
-      // Primitive types use zero-copy chunk-wise access (no iterator overhead)
-      df_readers_.push_back(
-          [name, accessor](const DataFrame& df,
-                           std::vector<RecordType>& records) {
-            auto col = df.template GetColumn<T>(name);
-            size_t row = 0;
-            for (size_t c = 0; c < col.NumChunks(); ++c) {
-              const auto& chunk = col.Chunk(c);
-              for (size_t i = 0; i < chunk.size() && row < records.size(); ++i) {
-                records[row++].*accessor = chunk[i];
-              }
-            }
-          });
+      // Primitive types use zero-copy chunk-wise access (no iterator
+      // overhead); a column stored as another numeric type is converted once
+      df_readers_.push_back([name, accessor](const DataFrameView& df) {
+        auto col = df.template GetColumnAs<T>(name);
+        return BoundReader(
+            [col, accessor](size_t begin, size_t n, RecordType* records) {
+              col.VisitRange(begin, n, [&](const T* ptr, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                  (records++)->*accessor = ptr[i];
+                }
+              });
+            });
+      });
     }
 
     // Register writer for ParquetWriter
-    column_writers_.push_back(
-        [name, accessor](ffi::ParquetWriter& writer,
-                         const std::vector<RecordType>& records) {
-          std::vector<T> data(records.size());
-          for (size_t i = 0; i < records.size(); ++i) {
-            data[i] = records[i].*accessor;
-          }
-          ParquetCellCodec<T>::Write(writer, name, data);
-        });
+    column_widths_.push_back(sizeof(T));
+    column_writers_.push_back([name, accessor](size_t num_rows) {
+      auto data = std::make_shared<std::vector<T>>(num_rows);
+      return ColumnSink{
+          [data, accessor](const RecordType* records, size_t begin, size_t n) {
+            auto& out = *data;
+            for (size_t row = begin; row < begin + n; ++row) {
+              out[row] = records[row].*accessor;
+            }
+          },
+          [data, name](ffi::ParquetWriter& writer) {
+            ParquetCellCodec<T>::Write(writer, name, *data);
+          }};
+    });
+  }
+
+  /// Rows per transposition block. Record and column data touched by one
+  /// block (about twice kTransposeBlockBytes) stay resident in L2, so each
+  /// column pass after the first hits cache instead of streaming the whole
+  /// record vector again.
+  static constexpr size_t BlockRows() {
+    return std::max<size_t>(16, kTransposeBlockBytes / sizeof(RecordType));
   }
 
   /// Read all records from a DataFrame (zero-copy column access)
   std::vector<RecordType> ReadAllFromDf(const DataFrame& df) const {
-    size_t num_rows = df.NumRows();
-    std::vector<RecordType> records(num_rows);
+    return ReadAllFromDf(df.View());
+  }
 
-    for (const auto& reader : df_readers_) {
-      reader(df, records);
-    }
+  /// Read all records through a read-only view (DataFrame or SharedDataFrame)
+  std::vector<RecordType> ReadAllFromDf(const DataFrameView& df) const {
+    return ReadColumnsFromDf(df, column_names_);
+  }
 
+  /// Read records populating only the registered columns listed in `names`.
+  /// Members of other columns keep their value-initialized state.
+  std::vector<RecordType> ReadColumnsFromDf(
+      const DataFrameView& df, const std::vector<std::string>& names) const {
+    std::vector<RecordType> records(df.NumRows());
+    Transpose(BindReaders(df, names), 0, records.size(), records.data());
     return records;
   }
 
+  /// ReadColumnsFromDf() appending to `records` instead of returning a new
+  /// vector.
+  void AppendColumnsFromDf(const DataFrameView& df,
+                           const std::vector<std::string>& names,
+                           std::vector<RecordType>& records) const {
+    size_t first = records.size();
+    records.resize(first + df.NumRows());
+    Transpose(BindReaders(df, names), 0, df.NumRows(), records.data() + first);
+  }
+
+  /// Transpose a DataFrame into `buffer` up to `batch_rows` records at a time
+  /// (0 = all rows at once), calling fn(std::span<const RecordType>) per batch.
+  ///
+  /// Only the columns listed in `names` are written. The buffer is grown to
+  /// the batch size and reused, so records keep their previous contents in
+  /// members that are not read and string capacity is recycled.
+  template <typename Fn>
+  void ForEachBatch(const DataFrameView& df,
+                    const std::vector<std::string>& names, size_t batch_rows,
+                    std::vector<RecordType>& buffer, Fn&& fn) const {
+    size_t num_rows = df.NumRows();
+    size_t window = batch_rows == 0 ? num_rows : batch_rows;
+    if (num_rows == 0) return;
+    if (buffer.size() < std::min(window, num_rows)) {
+      buffer.resize(std::min(window, num_rows));
+    }
+
+    auto readers = BindReaders(df, names);
+    for (size_t begin = 0; begin < num_rows; begin += window) {
+      size_t n = std::min(window, num_rows - begin);
+      Transpose(readers, begin, n, buffer.data());
+      fn(std::span<const RecordType>(buffer.data(), n));
+    }
+  }
+
   /// Get column names.
   const std::vector<std::string>& column_names() const { return column_names_; }
 
@@ -139,22 +217,97 @@ class ParquetCodec {
     throw std::runtime_error("Member pointer not registered in codec");
   }
 
-  using WriterFunc =
-      std::function<void(ffi::ParquetWriter&, const std::vector<RecordType>&)>;
+  /// Column writer for one batch: gather() copies members of rows
+  /// [begin, begin + n) into the column buffer, write() hands the finished
+  /// column to the Parquet writer.
+  struct ColumnSink {
+    std::function<void(const RecordType* records, size_t begin, size_t n)>
+        gather;
+    std::function<void(ffi::ParquetWriter&)> write;
+  };
+  /// Creates a ColumnSink sized for a batch of num_rows records.
+  using WriterFunc = std::function<ColumnSink(size_t num_rows)>;
 
   /// Write all records to a writer.
+  ///
+  /// Columns are processed in groups of up to kWriteGroupBytes of column
+  /// data. Within a group, records are gathered one block of rows at a time
+  /// across all of its columns, so each record is pulled into cache once
+  /// per group; the group is handed to the writer and released before the
+  /// next one is gathered.
+  ///
+  /// If a column fails to gather or write, the columns already handed to the
+  /// writer are dropped before rethrowing, so the writer can take the next
+  /// batch.
   void WriteAll(ffi::ParquetWriter& writer,
-                const std::vector<RecordType>& records) const {
-    for (const auto& write_col : column_writers_) {
-      write_col(writer, records);
+                std::span<const RecordType> records) const {
+    try {
+      constexpr size_t kBlock = BlockRows();
+      size_t first = 0;
+      while (first < column_writers_.size()) {
+        size_t last = first + 1;
+        size_t bytes = column_widths_[first] * records.size();
+        while (last < column_writers_.size() &&
+               bytes + column_widths_[last] * records.size() <=
+                   kWriteGroupBytes) {
+          bytes += column_widths_[last] * records.size();
+          ++last;
+        }
+
+        std::vector<ColumnSink> sinks;
+        sinks.reserve(last - first);
+        for (size_t c = first; c < last; ++c) {
+          sinks.push_back(column_writers_[c](records.size()));
+        }
+        for (size_t begin = 0; begin < records.size(); begin += kBlock) {
+          size_t n = std::min(kBlock, records.size() - begin);
+          for (const auto& sink : sinks) {
+            sink.gather(records.data(), begin, n);
+          }
+        }
+        for (const auto& sink : sinks) {
+          sink.write(writer);
+        }
+        first = last;
+      }
+    } catch (...) {
+      ffi::parquet_writer_clear_columns(writer);
+      throw;
     }
   }
 
  private:
+  /// Copy rows [begin, begin + n) of every bound column into out[0, n),
+  /// one block of rows at a time across all columns.
+  static void Transpose(const std::vector<BoundReader>& readers, size_t begin,
+                        size_t n, RecordType* out) {
+    constexpr size_t kBlock = BlockRows();
+    for (size_t done = 0; done < n; done += kBlock) {
+      size_t rows = std::min(kBlock, n - done);
+      for (const auto& reader : readers) {
+        reader(begin + done, rows, out + done);
+      }
+    }
+  }
+
+  /// Bind the readers of the registered columns listed in `names`.
+  std::vector<BoundReader> BindReaders(
+      const DataFrameView& df, const std::vector<std::string>& names) const {
+    std::vector<BoundReader> bound;
+    for (size_t i = 0; i < df_readers_.size(); ++i) {
+      if (std::find(names.begin(), names.end(), column_names_[i]) !=
+          names.end()) {
+        bound.push_back(df_readers_[i](df));
+      }
+    }
+    return bound;
+  }
+
   std::vector<std::string> column_names_;
   std::vector<std::ptrdiff_t> column_offsets_;
   std::vector<ReaderFromDf> df_readers_;
   std::vector<WriterFunc> column_writers_;
+  std::vector<size_t> column_widths_;  // sizeof each column's member type
 };
 
 }  // namespace basis_rs
@@ -2,8 +2,13 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace basis_rs {
@@ -111,6 +116,9 @@ class ColumnIterator {
 /// A column accessor that provides zero-copy access to column data.
 /// Supports seamless iteration across multiple chunks (row groups).
 ///
+/// Accessors returned by GetColumnAs<T>() for a converted column own their
+/// buffer (shared between copies) instead of pointing into the DataFrame.
+///
 /// Usage:
 ///   auto col = df.GetColumn<float>("Close");
 ///
@@ -146,12 +154,7 @@ class ColumnAccessor {
 
   /// Random access by index - O(log n) chunk lookup + O(1) element access
   const T& operator[](size_t idx) const {
-    // Binary search to find the right chunk
-    auto it =
-        std::upper_bound(chunk_offsets_.begin(), chunk_offsets_.end(), idx);
-    size_t chunk_idx = it - chunk_offsets_.begin();
-
-    size_t offset = (chunk_idx == 0) ? 0 : chunk_offsets_[chunk_idx - 1];
+    auto [chunk_idx, offset] = FindChunk(idx);
     return chunks_[chunk_idx][idx - offset];
   }
 
@@ -171,16 +174,146 @@ class ColumnAccessor {
 
   // ==================== Advanced API ====================
 
+  /// Keep `storage` alive for as long as this accessor (or a copy) exists.
+  /// Used for chunks that point into memory owned by the accessor.
+  void KeepAlive(std::shared_ptr<const void> storage) {
+    storage_ = std::move(storage);
+  }
+
+  /// True if the data is owned by the accessor rather than the DataFrame.
+  bool OwnsData() const { return storage_ != nullptr; }
+
   /// Number of chunks (usually equals number of row groups)
   size_t NumChunks() const { return chunks_.size(); }
 
   /// Access a specific chunk (for advanced users who need chunk-aware access)
   const ColumnChunkView<T>& Chunk(size_t i) const { return chunks_[i]; }
 
+  /// Index of the chunk holding element `idx` (< size()) and the index of
+  /// that chunk's first element. Binary search over the chunk offsets.
+  std::pair<size_t, size_t> FindChunk(size_t idx) const {
+    auto it =
+        std::upper_bound(chunk_offsets_.begin(), chunk_offsets_.end(), idx);
+    size_t chunk_idx = it - chunk_offsets_.begin();
+    return {chunk_idx, chunk_idx == 0 ? 0 : chunk_offsets_[chunk_idx - 1]};
+  }
+
+  /// Visit rows [begin, begin + count) as contiguous pieces.
+  ///
+  /// Calls fn(const T* data, size_t n) once per chunk overlapping the range,
+  /// in row order. The range is clamped to size().
+  template <typename Fn>
+  void VisitRange(size_t begin, size_t count, Fn&& fn) const {
+    size_t end = std::min(begin + count, total_size_);
+    if (begin >= end) return;
+    auto [chunk_idx, offset] = FindChunk(begin);
+    size_t row = begin;
+    while (row < end) {
+      const auto& chunk = chunks_[chunk_idx];
+      size_t in_chunk = row - offset;
+      size_t n = std::min(chunk.size() - in_chunk, end - row);
+      fn(chunk.data() + in_chunk, n);
+      row += n;
+      offset += chunk.size();
+      ++chunk_idx;
+    }
+  }
+
  private:
   std::vector<ColumnChunkView<T>> chunks_;
   std::vector<size_t> chunk_offsets_;  // Prefix sums for O(log n) lookup
   size_t total_size_ = 0;
+  std::shared_ptr<const void> storage_;  // Owned buffer of converted columns
 };
 
+namespace detail {
+
+/// `value / divisor` rounded toward negative infinity (divisor > 0), so a
+/// pre-epoch timestamp scaled to a coarser unit lands on the earlier tick:
+/// -1500 us is -2 ms, not -1. Branch-free so it vectorizes.
+template <typename T>
+constexpr T FloorDiv(T value, T divisor) {
+  T quotient = value / divisor;
+  if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    quotient -= static_cast<T>(value % divisor < 0);
+  }
+  return quotient;
+}
+
+/// Copy `src` into one owned, contiguous buffer of To, converting every
+/// value with static_cast (after floor-dividing by `divisor`, used to scale
+/// datetime units). One pass per chunk; the loops are plain element-wise
+/// casts so the compiler vectorizes them.
+///
+/// Integer narrowing is checked: throws std::out_of_range if a value does
+/// not fit in To. Floating-point to integer conversion is rejected with
+/// std::invalid_argument because it would silently truncate.
+template <typename To, typename From>
+ColumnAccessor<To> ConvertColumn(const ColumnAccessor<From>& src,
+                                 int64_t divisor = 1) {
+  if constexpr (std::is_integral_v<To> && std::is_floating_point_v<From>) {
+    throw std::invalid_argument(
+        "GetColumnAs: floating-point column cannot be read as an integer");
+  } else {
+    constexpr bool kNarrowing = [] {
+      if constexpr (std::is_integral_v<To> && std::is_integral_v<From>) {
+        return !std::in_range<To>(std::numeric_limits<From>::min()) ||
+               !std::in_range<To>(std::numeric_limits<From>::max());
+      } else {
+        return false;
+      }
+    }();
+
+    std::shared_ptr<To[]> data(new To[src.size()]);
+    To* out = data.get();
+    for (size_t c = 0; c < src.NumChunks(); ++c) {
+      const From* in = src.Chunk(c).data();
+      size_t n = src.Chunk(c).size();
+      if (divisor != 1) {
+        // Datetime unit scaling (integral sources only)
+        const From d = static_cast<From>(divisor);
+        for (size_t i = 0; i < n; ++i) {
+          out[i] = static_cast<To>(FloorDiv(in[i], d));
+        }
+      } else {
+        for (size_t i = 0; i < n; ++i) out[i] = static_cast<To>(in[i]);
+      }
+      if constexpr (kNarrowing) {
+        // Round-trip check as a separate reduction so the cast loop above
+        // stays branch-free
+        auto fits = [](From v, To o) {
+          bool same = static_cast<From>(o) == v;
+          if constexpr (std::is_signed_v<From> && !std::is_signed_v<To>) {
+            same &= v >= 0;
+          } else if constexpr (!std::is_signed_v<From> && std::is_signed_v<To>) {
+            same &= o >= 0;
+          }
+          return same;
+        };
+        bool lossless = true;
+        if (divisor != 1) {
+          const From d = static_cast<From>(divisor);
+          for (size_t i = 0; i < n; ++i) {
+            lossless &= fits(FloorDiv(in[i], d), out[i]);
+          }
+        } else {
+          for (size_t i = 0; i < n; ++i) lossless &= fits(in[i], out[i]);
+        }
+        if (!lossless) {
+          throw std::out_of_range(
+              "GetColumnAs: value out of range of the requested type");
+        }
+      }
+      out += n;
+    }
+
+    ColumnAccessor<To> result;
+    result.AddChunk(data.get(), src.size());
+    result.KeepAlive(std::move(data));
+    return result;
+  }
+}
+
+}  // namespace detail
+
 }  // namespace basis_rs
@@ -0,0 +1,256 @@
+#pragma once
+
+// This header should be included from parquet.hpp.
+// Do not include this header directly.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "column_accessor.hpp"
+#include "parallel.hpp"
+
+namespace basis_rs {
+
+namespace detail {
+
+inline constexpr uint64_t kGroupHashMul = 0x9E3779B97F4A7C15ull;
+
+/// Open-addressing index from key to dense group number, for the keys of
+/// one radix partition.
+template <typename Key>
+class GroupIndex {
+ public:
+  GroupIndex() : slots_(16, kEmpty), mask_(15) {}
+
+  /// Multiplicative hash; partitions use its top bits, slots the low ones.
+  static uint64_t Hash(Key key) {
+    return static_cast<uint64_t>(key) * kGroupHashMul;
+  }
+
+  /// Group number of `key`; `inserted` is set if the group is new.
+  uint32_t FindOrInsert(Key key, uint64_t hash, bool& inserted) {
+    size_t slot = Slot(hash);
+    while (true) {
+      uint32_t group = slots_[slot];
+      if (group == kEmpty) {
+        if ((keys.size() + 1) * 2 > slots_.size()) {
+          Grow();
+          return FindOrInsert(key, hash, inserted);
+        }
+        group = static_cast<uint32_t>(keys.size());
+        slots_[slot] = group;
+        keys.push_back(key);
+        inserted = true;
+        return group;
+      }
+      if (keys[group] == key) {
+        inserted = false;
+        return group;
+      }
+      slot = (slot + 1) & mask_;
+    }
+  }
+
+  std::vector<Key> keys;  // By group number
+
+ private:
+  static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+
+  size_t Slot(uint64_t hash) const { return (hash ^ (hash >> 29)) & mask_; }
+
+  void Grow() {
+    slots_.assign(slots_.size() * 2, kEmpty);
+    mask_ = slots_.size() - 1;
+    for (uint32_t group = 0; group < keys.size(); ++group) {
+      size_t slot = Slot(Hash(keys[group]));
+      while (slots_[slot] != kEmpty) slot = (slot + 1) & mask_;
+      slots_[slot] = group;
+    }
+  }
+
+  std::vector<uint32_t> slots_;
+  size_t mask_;
+};
+
+}  // namespace detail
+
+/// Parallel hash group-by over integer key columns with user-defined
+/// aggregate state, for aggregations that do not fit Polars expressions
+/// (e.g. per-StockId state machines).
+///
+/// Aggregate() runs in two parallel phases:
+/// 1. Rows are split into one contiguous range per thread. Each thread
+///    radix-partitions its range by the top bits of the key hash, writing
+///    the row numbers and keys of every partition into one shared array.
+/// 2. Each partition is aggregated by a single thread with its own
+///    open-addressing table and state vector. The table only holds that
+///    partition's keys, so it stays cache-resident. The per-partition results
+///    are then merged into one result sorted by key.
+///
+/// A key always lands in one partition, so its rows are fed to `fn` by one
+/// thread, in row order, and no merge of partial states is needed. `fn` may
+/// therefore be an order-dependent state machine.
+///
+/// Example:
+///   struct Vwap { double pv = 0; double v = 0; };
+///   auto ids = df.GetColumn<int64_t>("StockId");
+///   auto px = df.GetColumn<double>("price");
+///   auto qty = df.GetColumnAs<double>("qty");
+///   auto vwap = basis_rs::GroupBy(ids).Aggregate<Vwap>(
+///       std::tuple(px, qty), [](Vwap& s, double p, double q) {
+///         s.pv += p * q;
+///         s.v += q;
+///       });
+///   for (const auto& [id, s] : vwap) std::cout << id << " " << s.pv / s.v;
+template <typename Key>
+class GroupBy {
+  static_assert(std::is_integral_v<Key>,
+                "GroupBy keys must be integers (use GetInternedColumn for "
+                "strings)");
+
+ public:
+  explicit GroupBy(ColumnAccessor<Key> keys) : keys_(std::move(keys)) {}
+
+  /// Worker threads (default: hardware concurrency). Inputs below
+  /// kSerialRows rows are always aggregated on the calling thread.
+  GroupBy& WithThreads(size_t threads) {
+    threads_ = std::max<size_t>(threads, 1);
+    return *this;
+  }
+
+  /// Fold the rows of every key into a State.
+  ///
+  /// `values` holds one accessor per extra column, each as long as the key
+  /// column; `fn(State&, Values...)` is called once per row with that row's
+  /// values. Every group starts from a copy of `init`.
+  ///
+  /// Returns (key, state) pairs sorted by key.
+  template <typename State, typename... Values, typename Fn>
+  std::vector<std::pair<Key, State>> Aggregate(
+      const std::tuple<ColumnAccessor<Values>...>& values, Fn&& fn,
+      const State& init = State{}) const {
+    const size_t n = keys_.size();
+    std::apply(
+        [&](const auto&... cols) {
+          if (((cols.size() != n) || ...)) {
+            throw std::invalid_argument(
+                "GroupBy: value columns must have as many rows as the keys");
+          }
+        },
+        values);
+    if (n > std::numeric_limits<uint32_t>::max()) {
+      throw std::length_error("GroupBy supports up to 2^32 - 1 rows");
+    }
+
+    const size_t threads = n < kSerialRows ? 1 : threads_;
+    const int bits = threads == 1 ? 0 : kPartitionBits;
+    const size_t parts = size_t{1} << bits;
+    auto part_of = [bits](uint64_t hash) {
+      return bits == 0 ? size_t{0} : static_cast<size_t>(hash >> (64 - bits));
+    };
+
+    // Phase 1: histogram, then scatter (row, key) into partition-major
+    // order; within a partition rows stay ascending.
+    const size_t ranges = threads;
+    std::vector<size_t> counts(ranges * parts, 0);
+    auto range_begin = [&](size_t r) { return n * r / ranges; };
+
+    detail::ParallelFor(ranges, threads, [&](size_t r) {
+      size_t* count = &counts[r * parts];
+      keys_.VisitRange(range_begin(r), range_begin(r + 1) - range_begin(r),
+                       [&](const Key* k, size_t len) {
+                         for (size_t i = 0; i < len; ++i) {
+                           ++count[part_of(detail::GroupIndex<Key>::Hash(k[i]))];
+                         }
+                       });
+    });
+
+    // offsets[r * parts + p]: where range r writes partition p
+    std::vector<size_t> offsets(ranges * parts);
+    std::vector<size_t> part_begin(parts + 1, 0);
+    size_t total = 0;
+    for (size_t p = 0; p < parts; ++p) {
+      part_begin[p] = total;
+      for (size_t r = 0; r < ranges; ++r) {
+        offsets[r * parts + p] = total;
+        total += counts[r * parts + p];
+      }
+    }
+    part_begin[parts] = total;
+
+    std::vector<uint32_t> rows(n);
+    std::vector<Key> part_keys(n);
+    detail::ParallelFor(ranges, threads, [&](size_t r) {
+      size_t* offset = &offsets[r * parts];
+      size_t row = range_begin(r);
+      keys_.VisitRange(row, range_begin(r + 1) - row,
+                       [&](const Key* k, size_t len) {
+                         for (size_t i = 0; i < len; ++i, ++row) {
+                           size_t at = offset[part_of(
+                               detail::GroupIndex<Key>::Hash(k[i]))]++;
+                           rows[at] = static_cast<uint32_t>(row);
+                           part_keys[at] = k[i];
+                         }
+                       });
+    });
+
+    // Phase 2: aggregate each partition independently. Its rows ascend, so
+    // the value lookups mostly stay within one chunk.
+    std::vector<detail::GroupIndex<Key>> indexes(parts);
+    std::vector<std::vector<State>> states(parts);
+    detail::ParallelFor(parts, threads, [&](size_t p) {
+      auto lookups = std::apply(
+          [](const auto&... cols) {
+            return std::make_tuple(detail::RowLookup(cols)...);
+          },
+          values);
+      auto& index = indexes[p];
+      auto& part_states = states[p];
+      for (size_t i = part_begin[p]; i < part_begin[p + 1]; ++i) {
+        Key key = part_keys[i];
+        bool inserted;
+        uint32_t group = index.FindOrInsert(
+            key, detail::GroupIndex<Key>::Hash(key), inserted);
+        if (inserted) part_states.push_back(init);
+        std::apply(
+            [&](auto&... lookup) {
+              fn(part_states[group], lookup(rows[i])...);
+            },
+            lookups);
+      }
+    });
+
+    // Merge the partitions (their key sets are disjoint)
+    std::vector<std::pair<Key, State>> result;
+    size_t groups = 0;
+    for (const auto& index : indexes) groups += index.keys.size();
+    result.reserve(groups);
+    for (size_t p = 0; p < parts; ++p) {
+      for (size_t g = 0; g < indexes[p].keys.size(); ++g) {
+        result.emplace_back(indexes[p].keys[g], std::move(states[p][g]));
+      }
+    }
+    std::sort(result.begin(), result.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    return result;
+  }
+
+  /// Inputs smaller than this are aggregated single-threaded.
+  static constexpr size_t kSerialRows = 64 * 1024;
+
+ private:
+  // 256 partitions: enough to balance threads and keep each table small
+  static constexpr int kPartitionBits = 8;
+
+  ColumnAccessor<Key> keys_;
+  size_t threads_ = detail::DefaultKernelThreads();
+};
+
+}  // namespace basis_rs
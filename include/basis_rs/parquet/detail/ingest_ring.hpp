@@ -0,0 +1,263 @@
+#pragma once
+
+// This header should be included from parquet.hpp (after
+// ColumnarParquetWriter). Do not include this header directly.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace basis_rs {
+
+/// Column types an IngestRing can store: the ones ColumnarParquetWriter
+/// accepts by pointer.
+template <typename T>
+concept IngestColumn =
+    std::same_as<T, int32_t> || std::same_as<T, int64_t> ||
+    std::same_as<T, float> || std::same_as<T, double> || std::same_as<T, bool>;
+
+/// Counters of an IngestRing.
+struct IngestRingStats {
+  uint64_t rows_written = 0;
+  uint64_t segments_written = 0;
+  uint64_t dropped = 0;             // TryPush() calls rejected by a full ring
+  uint64_t backpressure_waits = 0;  // Push() calls that had to wait
+};
+
+/// Bounded lock-free multi-producer, single-consumer ingestion ring that
+/// stores rows directly as columns.
+///
+/// The ring is a fixed number of segments of `segment_rows` rows each; a
+/// segment holds one array per column (Structure of Arrays), so a full
+/// segment is a ready row group. Producers claim a row with one CAS and
+/// write its values straight into the column arrays; they never lock or
+/// allocate. The consumer thread hands full segments to a
+/// ColumnarParquetWriter without copying them (Drain()) and recycles them.
+///
+/// When every segment is full, TryPush() drops the row and Push() waits for
+/// the consumer; both are counted in Stats().
+///
+/// Example:
+///   basis_rs::IngestRing<int64_t, int32_t, double, int64_t> ring(
+///       {"ts", "symbol", "price", "qty"}, 100000);
+///   ring.AsDateTime("ts");
+///   // producers (any thread):
+///   ring.TryPush(now_ms, symbol_id, price, qty);
+///   // consumer thread:
+///   basis_rs::ColumnarParquetWriter writer("ticks.parquet");
+///   while (running) ring.Drain(writer);
+///   ring.Drain(writer, true);  // include the partially filled segment
+///   writer.Finish();
+template <IngestColumn... Columns>
+class IngestRing {
+ public:
+  static constexpr size_t kNumColumns = sizeof...(Columns);
+
+  /// Allocate `num_segments` segments of `segment_rows` rows each up front.
+  IngestRing(std::array<std::string, kNumColumns> names, size_t segment_rows,
+             size_t num_segments = 4)
+      : names_(std::move(names)),
+        segment_rows_(std::max<size_t>(segment_rows, 1)),
+        num_segments_(std::max<size_t>(num_segments, 2)),
+        segments_(std::make_unique<Segment[]>(num_segments_)) {
+    for (size_t i = 0; i < num_segments_; ++i) {
+      segments_[i].generation.store(i, std::memory_order_relaxed);
+      segments_[i].columns = std::make_tuple(
+          std::make_unique_for_overwrite<Columns[]>(segment_rows_)...);
+    }
+  }
+
+  // Producers and the consumer share the atomics by address
+  IngestRing(const IngestRing&) = delete;
+  IngestRing& operator=(const IngestRing&) = delete;
+
+  /// Write an int64 column as DateTime (milliseconds since epoch). Call
+  /// before the first Drain().
+  IngestRing& AsDateTime(std::string_view name) {
+    for (size_t i = 0; i < kNumColumns; ++i) {
+      if (names_[i] == name) {
+        if (!is_int64_[i]) {
+          throw std::invalid_argument("AsDateTime requires an int64 column: " +
+                                      std::string(name));
+        }
+        datetime_.set(i);
+        return *this;
+      }
+    }
+    throw std::invalid_argument("Unknown column: " + std::string(name));
+  }
+
+  /// Append a row if a segment has room; otherwise drop it and return false.
+  /// Wait-free apart from CAS retries; never allocates. Thread-safe.
+  bool TryPush(Columns... values) {
+    uint64_t row;
+    if (!TryClaim(row)) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    Store(row, values...);
+    return true;
+  }
+
+  /// Append a row, yielding while the ring is full. Never allocates.
+  /// Thread-safe.
+  void Push(Columns... values) {
+    uint64_t row;
+    if (!TryClaim(row)) {
+      backpressure_waits_.fetch_add(1, std::memory_order_relaxed);
+      do {
+        std::this_thread::yield();
+      } while (!TryClaim(row));
+    }
+    Store(row, values...);
+  }
+
+  /// Write every full segment to `writer` as one batch (row group) and
+  /// recycle it. With `include_partial`, the segment currently being filled
+  /// is sealed and written as well; producers continue in the next segment.
+  ///
+  /// Must only be called from the consumer thread. Returns rows written.
+  size_t Drain(ColumnarParquetWriter& writer, bool include_partial = false) {
+    size_t rows = 0;
+    while (true) {
+      Segment& seg = segments_[head_ % num_segments_];
+      size_t count = segment_rows_;
+      if (seg.committed.load(std::memory_order_acquire) != segment_rows_) {
+        if (!include_partial) break;
+        count = Seal();
+        if (count == 0) break;
+        // Rows are claimed; wait for their producers to finish storing them
+        while (seg.committed.load(std::memory_order_acquire) != count) {
+          std::this_thread::yield();
+        }
+      }
+
+      WriteSegment(writer, seg, count, std::index_sequence_for<Columns...>{});
+      seg.committed.store(0, std::memory_order_relaxed);
+      seg.generation.store(head_ + num_segments_, std::memory_order_release);
+      ++head_;
+      rows += count;
+      rows_written_.fetch_add(count, std::memory_order_relaxed);
+      segments_written_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return rows;
+  }
+
+  IngestRingStats Stats() const {
+    return {rows_written_.load(std::memory_order_relaxed),
+            segments_written_.load(std::memory_order_relaxed),
+            dropped_.load(std::memory_order_relaxed),
+            backpressure_waits_.load(std::memory_order_relaxed)};
+  }
+
+  size_t SegmentRows() const { return segment_rows_; }
+
+ private:
+  struct Segment {
+    // Lap of the ring this segment accepts rows for: row r belongs to
+    // generation r / segment_rows_. Advanced by the consumer on recycle.
+    alignas(64) std::atomic<uint64_t> generation{0};
+    // Rows stored in the current generation
+    alignas(64) std::atomic<size_t> committed{0};
+    std::tuple<std::unique_ptr<Columns[]>...> columns;
+  };
+
+  bool TryClaim(uint64_t& row) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    while (true) {
+      uint64_t gen = tail / segment_rows_;
+      uint64_t seg_gen = segments_[gen % num_segments_].generation.load(
+          std::memory_order_acquire);
+      if (seg_gen != gen) {
+        // Not yet drained from the previous lap: the ring is full
+        if (seg_gen < gen) return false;
+        // Our view of the tail is stale
+        tail = tail_.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (tail_.compare_exchange_weak(tail, tail + 1,
+                                      std::memory_order_relaxed)) {
+        row = tail;
+        return true;
+      }
+    }
+  }
+
+  void Store(uint64_t row, Columns... values) {
+    Segment& seg = segments_[(row / segment_rows_) % num_segments_];
+    StoreColumns(seg, row % segment_rows_,
+                 std::index_sequence_for<Columns...>{}, values...);
+    seg.committed.fetch_add(1, std::memory_order_release);
+  }
+
+  template <size_t... I>
+  static void StoreColumns(Segment& seg, size_t slot, std::index_sequence<I...>,
+                           Columns... values) {
+    ((std::get<I>(seg.columns)[slot] = values), ...);
+  }
+
+  // Move the tail past the head segment so producers start the next one.
+  // Returns the number of rows claimed in the head segment.
+  size_t Seal() {
+    uint64_t begin = head_ * segment_rows_;
+    uint64_t end = begin + segment_rows_;
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    while (true) {
+      if (tail >= end) return segment_rows_;
+      if (tail == begin) return 0;
+      if (tail_.compare_exchange_weak(tail, end, std::memory_order_relaxed)) {
+        return tail - begin;
+      }
+    }
+  }
+
+  template <size_t... I>
+  void WriteSegment(ColumnarParquetWriter& writer, Segment& seg, size_t count,
+                    std::index_sequence<I...>) {
+    (AddColumn(writer, I, std::get<I>(seg.columns).get(), count), ...);
+    writer.WriteBatch();
+  }
+
+  template <typename T>
+  void AddColumn(ColumnarParquetWriter& writer, size_t index, const T* data,
+                 size_t count) {
+    if constexpr (std::is_same_v<T, int64_t>) {
+      if (datetime_.test(index)) {
+        writer.AddDateTimeColumn(names_[index], data, count);
+        return;
+      }
+    }
+    writer.AddColumn(names_[index], data, count);
+  }
+
+  static constexpr std::array<bool, kNumColumns> is_int64_ = {
+      std::is_same_v<Columns, int64_t>...};
+
+  std::array<std::string, kNumColumns> names_;
+  std::bitset<kNumColumns> datetime_;
+  const size_t segment_rows_;
+  const size_t num_segments_;
+  std::unique_ptr<Segment[]> segments_;
+
+  alignas(64) std::atomic<uint64_t> tail_{0};  // Next row to claim
+  uint64_t head_ = 0;  // Generation the consumer drains next
+
+  alignas(64) std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> backpressure_waits_{0};
+  std::atomic<uint64_t> rows_written_{0};
+  std::atomic<uint64_t> segments_written_{0};
+};
+
+}  // namespace basis_rs
@@ -0,0 +1,95 @@
+#pragma once
+
+// This header should be included from parquet.hpp.
+// Do not include this header directly.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "column_accessor.hpp"
+
+namespace basis_rs {
+namespace detail {
+
+/// Default worker count of the C++ kernels (GroupBy, ArgSort).
+inline size_t DefaultKernelThreads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/// Run fn(task) for task in [0, num_tasks) on up to `threads` threads
+/// (the caller's thread included). Tasks are claimed dynamically; the first
+/// exception thrown by a task is rethrown after all threads finish.
+template <typename Fn>
+void ParallelFor(size_t num_tasks, size_t threads, Fn&& fn) {
+  if (num_tasks == 0) return;
+  threads = std::clamp<size_t>(threads, 1, num_tasks);
+  if (threads <= 1) {
+    for (size_t task = 0; task < num_tasks; ++task) fn(task);
+    return;
+  }
+
+  std::atomic<size_t> next{0};
+  std::exception_ptr error;
+  std::mutex error_mu;
+  auto worker = [&] {
+    try {
+      for (size_t task; (task = next.fetch_add(1)) < num_tasks;) fn(task);
+    } catch (...) {
+      std::lock_guard lock(error_mu);
+      if (!error) error = std::current_exception();
+      next.store(num_tasks);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (size_t i = 1; i < threads; ++i) pool.emplace_back(worker);
+  worker();
+  for (auto& t : pool) t.join();
+  if (error) std::rethrow_exception(error);
+}
+
+/// Random row access into a ColumnAccessor.
+///
+/// Caches the chunk of the last row read, so rows that stay in one chunk
+/// (every row of a single-chunk column, runs of ascending rows in a
+/// multi-chunk one) cost one compare and an index. Only a row outside the
+/// cached chunk falls back to the binary search over chunks. The cache
+/// makes lookups stateful: use one RowLookup per thread.
+template <typename T>
+class RowLookup {
+ public:
+  explicit RowLookup(const ColumnAccessor<T>& column) : column_(&column) {
+    if (column.NumChunks() > 0) Seek(0);
+  }
+
+  T operator()(size_t row) {
+    size_t at = row - begin_;  // Wraps around for rows before the chunk
+    if (at >= len_) [[unlikely]] {
+      Seek(row);
+      at = row - begin_;
+    }
+    return data_[at];
+  }
+
+ private:
+  void Seek(size_t row) {
+    auto [chunk, begin] = column_->FindChunk(row);
+    data_ = column_->Chunk(chunk).data();
+    len_ = column_->Chunk(chunk).size();
+    begin_ = begin;
+  }
+
+  const ColumnAccessor<T>* column_;
+  const T* data_ = nullptr;
+  size_t begin_ = 0;  // Row of data_[0]
+  size_t len_ = 0;
+};
+
+}  // namespace detail
+}  // namespace basis_rs
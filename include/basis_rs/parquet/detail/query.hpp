@@ -6,16 +6,88 @@
 #include <cstdint>
 #include <filesystem>
 #include <functional>
+#include <map>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
+#include "absl/time/time.h"
 #include "cxx_bridge.rs.h"
 
 namespace basis_rs {
 
-// Forward declaration
+// Forward declarations
+class CollectAwaitable;
 class DataFrame;
 
+template <typename RecordType>
+class ParquetCodec;
+
+template <typename RecordType>
+const ParquetCodec<RecordType>& GetParquetCodec();
+
+/// Append a typed comparison to a query. The overload picks the literal type,
+/// which must match the column type for predicate pushdown to apply.
+inline void ApplyFilter(ffi::ParquetQuery& q, const std::string& column,
+                        ffi::FilterOp op, int64_t value) {
+  ffi::parquet_query_filter_i64(q, column, op, value);
+}
+
+inline void ApplyFilter(ffi::ParquetQuery& q, const std::string& column,
+                        ffi::FilterOp op, int32_t value) {
+  ffi::parquet_query_filter_i32(q, column, op, value);
+}
+
+inline void ApplyFilter(ffi::ParquetQuery& q, const std::string& column,
+                        ffi::FilterOp op, double value) {
+  ffi::parquet_query_filter_f64(q, column, op, value);
+}
+
+inline void ApplyFilter(ffi::ParquetQuery& q, const std::string& column,
+                        ffi::FilterOp op, float value) {
+  ffi::parquet_query_filter_f32(q, column, op, value);
+}
+
+inline void ApplyFilter(ffi::ParquetQuery& q, const std::string& column,
+                        ffi::FilterOp op, const std::string& value) {
+  ffi::parquet_query_filter_str(q, column, op, value);
+}
+
+inline void ApplyFilter(ffi::ParquetQuery& q, const std::string& column,
+                        ffi::FilterOp op, bool value) {
+  ffi::parquet_query_filter_bool(q, column, op, value);
+}
+
+/// Datetime columns compare against an absolute instant; the literal is
+/// converted to the column's unit and time zone when the query runs.
+inline void ApplyFilter(ffi::ParquetQuery& q, const std::string& column,
+                        ffi::FilterOp op, absl::Time value) {
+  ffi::parquet_query_filter_datetime(q, column, op, absl::ToUnixMillis(value));
+}
+
+/// Build a sidecar key index for an integer column of a Parquet file.
+///
+/// Writes `<path>.<column>.keyidx`, mapping each key to the row spans (at
+/// most one per row group) that contain it, in one parallel pass over the
+/// column. Afterwards, DataFrameBuilder queries with Filter(column, Eq, key)
+/// or FilterIn(column, keys) read only those spans instead of every row
+/// group. Useful for files that are clustered, but not sorted, by key.
+///
+/// The index is ignored (full scan) once the file's size or mtime changes;
+/// call BuildKeyIndex() again after rewriting the file.
+///
+/// Example:
+///   BuildKeyIndex("ticks.parquet", "StockId");
+///   auto df = DataFrame::Open("ticks.parquet")
+///                 .Filter("StockId", FilterOp::Eq, 600000)
+///                 .Collect();
+inline void BuildKeyIndex(const std::filesystem::path& path,
+                          const std::string& column) {
+  ffi::parquet_build_key_index(path.string(), column);
+}
+
 /// Builder for creating DataFrame with optional filtering and column selection.
 /// Filters are pushed down to the Parquet reader for efficiency.
 class DataFrameBuilder {
@@ -41,7 +113,7 @@ class DataFrameBuilder {
                            int64_t value) {
     filter_entries_.push_back(
         {column, op, [column, op, value](ffi::ParquetQuery& q) {
-           ffi::parquet_query_filter_i64(q, column, op, value);
+           ApplyFilter(q, column, op, value);
          }});
     return *this;
   }
@@ -50,7 +122,7 @@ class DataFrameBuilder {
                            int32_t value) {
     filter_entries_.push_back(
         {column, op, [column, op, value](ffi::ParquetQuery& q) {
-           ffi::parquet_query_filter_i32(q, column, op, value);
+           ApplyFilter(q, column, op, value);
          }});
     return *this;
   }
@@ -59,7 +131,7 @@ class DataFrameBuilder {
                            double value) {
     filter_entries_.push_back(
         {column, op, [column, op, value](ffi::ParquetQuery& q) {
-           ffi::parquet_query_filter_f64(q, column, op, value);
+           ApplyFilter(q, column, op, value);
          }});
     return *this;
   }
@@ -68,7 +140,7 @@ class DataFrameBuilder {
                            float value) {
     filter_entries_.push_back(
         {column, op, [column, op, value](ffi::ParquetQuery& q) {
-           ffi::parquet_query_filter_f32(q, column, op, value);
+           ApplyFilter(q, column, op, value);
          }});
     return *this;
   }
@@ -77,7 +149,7 @@ class DataFrameBuilder {
                            const std::string& value) {
     filter_entries_.push_back(
         {column, op, [column, op, value](ffi::ParquetQuery& q) {
-           ffi::parquet_query_filter_str(q, column, op, value);
+           ApplyFilter(q, column, op, value);
          }});
     return *this;
   }
@@ -86,14 +158,78 @@ class DataFrameBuilder {
                            bool value) {
     filter_entries_.push_back(
         {column, op, [column, op, value](ffi::ParquetQuery& q) {
-           ffi::parquet_query_filter_bool(q, column, op, value);
+           ApplyFilter(q, column, op, value);
+         }});
+    return *this;
+  }
+
+  /// Filter a Datetime column by instant, e.g. a time window:
+  ///   .Filter("ts", Ge, absl::FromCivil(start, GetShanghaiTimeZone()))
+  ///   .Filter("ts", Lt, absl::FromCivil(end, GetShanghaiTimeZone()))
+  DataFrameBuilder& Filter(const std::string& column, ffi::FilterOp op,
+                           absl::Time value) {
+    filter_entries_.push_back(
+        {column, op, [column, op, value](ffi::ParquetQuery& q) {
+           ApplyFilter(q, column, op, value);
          }});
     return *this;
   }
 
+  /// Keep rows whose integer column value is one of `values` (Int32 or
+  /// Int64 column). Served by a key index if one was built for the column.
+  DataFrameBuilder& FilterIn(const std::string& column,
+                             std::vector<int64_t> values) {
+    filter_entries_.push_back(
+        {column, ffi::FilterOp::Eq,
+         [column, values = std::move(values)](ffi::ParquetQuery& q) {
+           ffi::parquet_query_filter_in_i64(
+               q, column,
+               rust::Slice<const int64_t>(values.data(), values.size()));
+         }});
+    return *this;
+  }
+
+  /// Attach a cancellation token (see CancellationToken). Collect(),
+  /// ForEachRecords() and CollectAwait() then stop between batches once it
+  /// is cancelled and throw OperationCancelled.
+  ///
+  /// A cancellable Collect() still reads only the row groups chosen by the
+  /// key index or sorted row-group planning. It reads them one row group at
+  /// a time, checking the token before each, and reuses the footer read for
+  /// planning. Row groups are not decoded concurrently with each other, so
+  /// expect some overhead compared with an uncancellable Collect() on files
+  /// with many small row groups.
+  DataFrameBuilder& WithCancellation(CancellationToken token) {
+    cancel_ = std::move(token);
+    return *this;
+  }
+
   /// Execute query and return DataFrame
   DataFrame Collect() const;
 
+  /// Collect() from a coroutine without blocking its thread:
+  ///   DataFrame df = co_await DataFrame::Open(path).Filter(...).CollectAwait();
+  /// The query runs on the Polars pool; see ResumeFn for where the coroutine
+  /// resumes.
+  CollectAwaitable CollectAwait(ResumeFn resume = {}) const;
+
+  /// Stream the query result as struct records, one row group at a time.
+  ///
+  /// Each row group is decoded, filtered and transposed via the registered
+  /// ParquetCodec into a buffer of at most `batch_rows` records (0 = whole
+  /// row group), and fn(std::span<const RecordType>) is called per batch.
+  /// The buffer is reused across batches, so spans are only valid during the
+  /// callback. Without Select(), only the codec's columns are read.
+  ///
+  /// Example:
+  ///   DataFrame::Open("trades.parquet")
+  ///       .Filter("price", FilterOp::Gt, 100.0)
+  ///       .ForEachRecords<Trade>(4096, [&](std::span<const Trade> batch) {
+  ///         for (const auto& t : batch) Process(t);
+  ///       });
+  template <typename RecordType, typename Fn>
+  void ForEachRecords(size_t batch_rows, Fn&& fn) const;
+
   /// Check if any filters are set
   bool HasFilters() const { return !filter_entries_.empty(); }
 
@@ -110,6 +246,8 @@ class DataFrameBuilder {
 
  private:
   friend class DataFrame;
+  template <typename>
+  friend class TypedQuery;
 
   struct FilterEntry {
     std::string column;
@@ -117,9 +255,175 @@ class DataFrameBuilder {
     std::function<void(ffi::ParquetQuery&)> apply;
   };
 
+  /// Build the FFI query: projection on `columns` plus filter columns (no
+  /// projection if `columns` is empty), then all filters.
+  rust::Box<ffi::ParquetQuery> BuildQuery(
+      const std::vector<std::string>& columns) const;
+
+  /// Run the query on `columns` one row group at a time, calling
+  /// fn(const DataFrameView&) with each filtered batch. Only one batch is
+  /// alive at a time.
+  template <typename Fn>
+  void ForEachBatchFrame(const std::vector<std::string>& columns,
+                         Fn&& fn) const;
+
   std::filesystem::path path_;
   std::vector<std::string> select_names_;
   std::vector<FilterEntry> filter_entries_;
+  std::optional<CancellationToken> cancel_;
+};
+
+/// True if a filter literal of type V can be pushed down against a column
+/// backing a member of type T without changing the comparison semantics.
+///
+/// Floating-point literals must match exactly (a float literal against a
+/// double column compares against the float's rounded value). Integer
+/// literals may be narrower than the member as long as every value of V is
+/// representable in T.
+template <typename T, typename V>
+inline constexpr bool kFilterLiteralMatches = [] {
+  using L = std::remove_cvref_t<V>;
+  if constexpr (std::is_same_v<T, std::string>) {
+    return std::is_convertible_v<const L&, std::string_view>;
+  } else if constexpr (std::is_same_v<T, bool> || std::is_same_v<L, bool>) {
+    return std::is_same_v<T, L>;
+  } else if constexpr (std::is_integral_v<T> && std::is_integral_v<L>) {
+    if constexpr (std::is_signed_v<T> == std::is_signed_v<L>) {
+      return sizeof(L) <= sizeof(T);
+    } else {
+      return std::is_signed_v<T> && sizeof(L) < sizeof(T);
+    }
+  } else {
+    return std::is_same_v<T, L>;
+  }
+}();
+
+/// Query builder addressed by struct members instead of column names.
+///
+/// Column names are resolved through the registered ParquetCodec, and filter
+/// literals are checked against the member type at compile time. Without
+/// Select(), exactly the codec's columns are read from disk.
+///
+/// Example:
+///   auto trades = DataFrame::Query<Trade>("trades.parquet")
+///       .Where(&Trade::price, Gt, 100.0)      // 100.0f would not compile
+///       .Select(&Trade::id, &Trade::price)
+///       .CollectAs<Trade>();
+template <typename RecordType>
+class TypedQuery {
+ public:
+  explicit TypedQuery(std::filesystem::path path) : builder_(std::move(path)) {}
+
+  /// Filter on a codec column (predicate pushdown).
+  ///
+  /// Supported member types: int32_t, int64_t, float, double, std::string, bool.
+  template <typename T, typename SuperType, typename V>
+  TypedQuery& Where(T SuperType::*member, ffi::FilterOp op, V&& value) {
+    static_assert(std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+                      std::is_same_v<T, float> || std::is_same_v<T, double> ||
+                      std::is_same_v<T, std::string> || std::is_same_v<T, bool>,
+                  "Where() supports int32_t, int64_t, float, double, "
+                  "std::string and bool members");
+    static_assert(kFilterLiteralMatches<T, V>,
+                  "Filter literal type does not match the member type; "
+                  "use a literal of the member's exact type (e.g. 1.0 for "
+                  "double, 1.0f for float)");
+    builder_.Filter(GetParquetCodec<RecordType>().FindColumnName(member), op,
+                    T(std::forward<V>(value)));
+    return *this;
+  }
+
+  /// Attach a cancellation token (see DataFrameBuilder::WithCancellation).
+  TypedQuery& WithCancellation(CancellationToken token) {
+    builder_.WithCancellation(std::move(token));
+    return *this;
+  }
+
+  /// Restrict the columns read from disk to the given codec members.
+  template <typename... Members>
+  TypedQuery& Select(Members... members) {
+    const auto& codec = GetParquetCodec<RecordType>();
+    (selected_.push_back(codec.FindColumnName(members)), ...);
+    return *this;
+  }
+
+  /// Execute the query and return the projected DataFrame.
+  DataFrame Collect() const;
+
+  /// Execute the query and transpose the result into records.
+  ///
+  /// Only the selected members (or all codec members, without Select()) are
+  /// populated; the others keep their value-initialized state.
+  ///
+  /// The collect is fused with the transposition: row groups are read,
+  /// filtered and appended to the records one at a time, so only one row
+  /// group's DataFrame is alive next to the records. Row groups that the key
+  /// index or sorted row-group planning excludes are skipped. Row groups are
+  /// decoded one after another rather than in parallel.
+  template <typename OutType = RecordType>
+  std::vector<OutType> CollectAs() const {
+    static_assert(std::is_same_v<OutType, RecordType>,
+                  "CollectAs<T>() must use the query's record type");
+    const auto& codec = GetParquetCodec<RecordType>();
+    const auto& columns = Projection();
+    std::vector<RecordType> records;
+    builder_.ForEachBatchFrame(columns, [&](const DataFrameView& batch) {
+      codec.AppendColumnsFromDf(batch, columns, records);
+    });
+    return records;
+  }
+
+ private:
+  const std::vector<std::string>& Projection() const {
+    return selected_.empty() ? GetParquetCodec<RecordType>().column_names()
+                             : selected_;
+  }
+
+  DataFrameBuilder builder_;
+  std::vector<std::string> selected_;
+};
+
+/// Query for many keys across many files with one read per file.
+///
+/// Each file is read once, in parallel, with `key_column IN keys` (using a
+/// key index or sorted row-group statistics where available). The rows are
+/// then split by key. I/O scales with the number of files rather than files
+/// times keys.
+///
+/// Example:
+///   auto by_stock = BatchQuery(day_files, "StockId", stock_ids)
+///                       .Select({"StockId", "ts", "price"})
+///                       .Collect();
+///   const DataFrame& ticks = by_stock.at(600000);  // rows of all days
+class BatchQuery {
+ public:
+  BatchQuery(std::vector<std::filesystem::path> paths, std::string key_column,
+             std::vector<int64_t> keys)
+      : paths_(std::move(paths)),
+        key_column_(std::move(key_column)),
+        keys_(std::move(keys)) {}
+
+  /// Select specific columns to read (projection pushdown)
+  BatchQuery& Select(std::initializer_list<std::string> names) {
+    select_names_.insert(select_names_.end(), names.begin(), names.end());
+    return *this;
+  }
+
+  BatchQuery& Select(const std::vector<std::string>& names) {
+    select_names_.insert(select_names_.end(), names.begin(), names.end());
+    return *this;
+  }
+
+  /// Execute the query. Every requested key has an entry; its rows are in
+  /// file order (files in the order given). Keys with no rows map to an
+  /// empty DataFrame with the projected schema.
+  std::map<int64_t, DataFrame> Collect() const;
+
+ private:
+  std::vector<std::filesystem::path> paths_;
+  std::string key_column_;
+  std::vector<int64_t> keys_;
+  std::vector<std::string> select_names_;
 };
 
 }  // namespace basis_rs
@@ -0,0 +1,252 @@
+#pragma once
+
+// This header should be included from parquet.hpp.
+// Do not include this header directly.
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "column_accessor.hpp"
+#include "parallel.hpp"
+
+namespace basis_rs {
+
+enum class SortOrder { kAscending, kDescending };
+
+/// Options of ArgSort().
+struct SortOptions {
+  SortOrder order = SortOrder::kAscending;  // Applies to every key
+  size_t threads = detail::DefaultKernelThreads();
+};
+
+namespace detail {
+
+/// Inputs smaller than this are sorted and gathered single-threaded.
+inline constexpr size_t kSortSerialRows = 64 * 1024;
+
+/// Unsigned integer of the same width as T.
+template <typename T>
+using RadixKey = std::conditional_t<
+    sizeof(T) == 1, uint8_t,
+    std::conditional_t<sizeof(T) == 2, uint16_t,
+                       std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+
+/// Map a value to an unsigned key whose unsigned order is the value order
+/// (inverted for descending). NaNs sort last in both orders.
+template <typename T>
+RadixKey<T> ToRadixKey(T value, bool descending) {
+  using U = RadixKey<T>;
+  constexpr U kSign = U{1} << (sizeof(U) * 8 - 1);
+  U key;
+  if constexpr (std::is_floating_point_v<T>) {
+    if (std::isnan(value)) return std::numeric_limits<U>::max();
+    if (value == T{0}) value = T{0};  // -0.0 ties with 0.0
+    U bits = std::bit_cast<U>(value);
+    // Negative: flip all bits (larger magnitude sorts first); positive: set
+    // the sign bit so it sorts after every negative. The key is never 0, so
+    // its descending complement never collides with the NaN key.
+    key = (bits & kSign) ? static_cast<U>(~bits) : static_cast<U>(bits | kSign);
+  } else if constexpr (std::is_signed_v<T>) {
+    key = static_cast<U>(static_cast<U>(value) ^ kSign);
+  } else {
+    key = static_cast<U>(value);
+  }
+  return descending ? static_cast<U>(~key) : key;
+}
+
+/// Stable LSD radix sort of `perm` by one column, one byte per pass.
+///
+/// The keys are gathered in the current `perm` order (so ties keep the
+/// order left by previous, less significant columns), counting every byte
+/// at once. Bytes that are equal in all rows (e.g. the high bytes of
+/// timestamps within a day) are skipped. Each pass splits the rows into one
+/// range per thread: histogram, prefix sums over (bucket, range), scatter.
+template <typename T>
+void RadixSortColumn(const ColumnAccessor<T>& column, bool descending,
+                     std::vector<uint32_t>& perm,
+                     std::vector<uint32_t>& perm_tmp, size_t threads) {
+  using U = RadixKey<T>;
+  constexpr size_t kBytes = sizeof(U);
+  constexpr size_t kBuckets = 256;
+  const size_t n = perm.size();
+  const size_t ranges = threads;
+  auto range_begin = [&](size_t r) { return n * r / ranges; };
+
+  // counts[(r * kBytes + b) * kBuckets + v]: rows of range r whose byte b
+  // is v
+  std::vector<U> keys(n);
+  std::vector<size_t> counts(ranges * kBytes * kBuckets, 0);
+  ParallelFor(ranges, threads, [&](size_t r) {
+    RowLookup lookup(column);
+    size_t* count = &counts[r * kBytes * kBuckets];
+    for (size_t i = range_begin(r); i < range_begin(r + 1); ++i) {
+      U key = ToRadixKey(lookup(perm[i]), descending);
+      keys[i] = key;
+      for (size_t b = 0; b < kBytes; ++b) {
+        ++count[b * kBuckets + ((key >> (8 * b)) & 0xFF)];
+      }
+    }
+  });
+
+  std::vector<U> keys_tmp(n);
+  std::vector<size_t> offsets(ranges * kBuckets);
+  bool fresh = true;  // Ranges still hold the rows counted at gather time
+  for (size_t b = 0; b < kBytes; ++b) {
+    const size_t shift = 8 * b;
+    auto range_counts = [&](size_t r) {
+      return &counts[(r * kBytes + b) * kBuckets];
+    };
+
+    bool constant = false;
+    for (size_t v = 0; v < kBuckets && !constant; ++v) {
+      size_t total = 0;
+      for (size_t r = 0; r < ranges; ++r) total += range_counts(r)[v];
+      constant = total == n;
+    }
+    if (constant) continue;
+
+    if (!fresh) {
+      ParallelFor(ranges, threads, [&](size_t r) {
+        size_t* count = range_counts(r);
+        std::fill(count, count + kBuckets, 0);
+        for (size_t i = range_begin(r); i < range_begin(r + 1); ++i) {
+          ++count[(keys[i] >> shift) & 0xFF];
+        }
+      });
+    }
+
+    size_t total = 0;
+    for (size_t v = 0; v < kBuckets; ++v) {
+      for (size_t r = 0; r < ranges; ++r) {
+        offsets[r * kBuckets + v] = total;
+        total += range_counts(r)[v];
+      }
+    }
+
+    ParallelFor(ranges, threads, [&](size_t r) {
+      size_t* offset = &offsets[r * kBuckets];
+      for (size_t i = range_begin(r); i < range_begin(r + 1); ++i) {
+        U key = keys[i];
+        size_t at = offset[(key >> shift) & 0xFF]++;
+        keys_tmp[at] = key;
+        perm_tmp[at] = perm[i];
+      }
+    });
+    keys.swap(keys_tmp);
+    perm.swap(perm_tmp);
+    fresh = false;
+  }
+}
+
+}  // namespace detail
+
+/// Permutation that sorts the rows by the given key columns: the first
+/// column is the most significant, ties are broken by the next one, and
+/// rows with equal keys keep their original order (stable).
+///
+/// Runs a parallel LSD radix sort over one byte per pass, least
+/// significant column first. Integer keys are sorted by their bytes with
+/// the sign bit flipped; floating-point keys by their IEEE bits, flipped so
+/// that unsigned order is numeric order (NaNs last). DateTime columns are
+/// int64 keys. Passes over bytes that are the same in every row are
+/// skipped, so narrow value ranges (StockIds, one day of timestamps) cost
+/// few passes.
+///
+/// Use the result with Take() to materialize sorted columns, or with
+/// DataFrame::Take() for a whole sorted DataFrame.
+///
+/// Throws std::invalid_argument if the columns differ in length.
+///
+/// Example:
+///   auto order = basis_rs::ArgSort(df.GetColumn<int64_t>("StockId"),
+///                                  df.GetColumn<int64_t>("Timestamp"));
+///   auto sorted = df.Take(order);
+///   auto latest_first = basis_rs::ArgSort(
+///       {.order = basis_rs::SortOrder::kDescending}, ts);
+template <typename... Keys>
+std::vector<uint32_t> ArgSort(const SortOptions& options,
+                              const ColumnAccessor<Keys>&... keys) {
+  static_assert(sizeof...(Keys) > 0, "ArgSort needs at least one key column");
+  static_assert(
+      ((std::is_arithmetic_v<Keys> && !std::is_same_v<Keys, bool>) && ...),
+      "ArgSort keys must be integer or floating-point columns");
+
+  auto columns = std::forward_as_tuple(keys...);
+  const size_t n = std::get<0>(columns).size();
+  if (((keys.size() != n) || ...)) {
+    throw std::invalid_argument(
+        "ArgSort: key columns must have the same number of rows");
+  }
+  if (n > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("ArgSort supports up to 2^32 - 1 rows");
+  }
+
+  std::vector<uint32_t> perm(n);
+  std::iota(perm.begin(), perm.end(), uint32_t{0});
+  std::vector<uint32_t> perm_tmp(n);
+  const size_t threads =
+      n < detail::kSortSerialRows ? 1 : std::max<size_t>(options.threads, 1);
+  const bool descending = options.order == SortOrder::kDescending;
+
+  // Least significant column first
+  [&]<size_t... I>(std::index_sequence<I...>) {
+    (detail::RadixSortColumn(std::get<sizeof...(Keys) - 1 - I>(columns),
+                             descending, perm, perm_tmp, threads),
+     ...);
+  }(std::index_sequence_for<Keys...>{});
+  return perm;
+}
+
+/// ArgSort() in ascending order with the default thread count.
+template <typename... Keys>
+std::vector<uint32_t> ArgSort(const ColumnAccessor<Keys>&... keys) {
+  return ArgSort(SortOptions{}, keys...);
+}
+
+/// Gather `column[rows[i]]` into a new contiguous accessor that owns its
+/// data (the source DataFrame may be released afterwards).
+///
+/// Throws std::out_of_range if an index is not below column.size().
+///
+/// Example:
+///   auto order = basis_rs::ArgSort(ids, ts);
+///   auto sorted_px = basis_rs::Take(df.GetColumn<double>("price"), order);
+template <typename T>
+ColumnAccessor<T> Take(const ColumnAccessor<T>& column,
+                       std::span<const uint32_t> rows,
+                       size_t threads = detail::DefaultKernelThreads()) {
+  const size_t n = rows.size();
+  std::shared_ptr<T[]> data(new T[n]);
+  if (n < detail::kSortSerialRows) threads = 1;
+  threads = std::max<size_t>(threads, 1);
+
+  const size_t size = column.size();
+  detail::ParallelFor(threads, threads, [&](size_t r) {
+    detail::RowLookup lookup(column);
+    for (size_t i = n * r / threads; i < n * (r + 1) / threads; ++i) {
+      if (rows[i] >= size) {
+        throw std::out_of_range("Take: row index out of range");
+      }
+      data[i] = lookup(rows[i]);
+    }
+  });
+
+  ColumnAccessor<T> result;
+  result.AddChunk(data.get(), n);
+  result.KeepAlive(std::move(data));
+  return result;
+}
+
+}  // namespace basis_rs
@@ -0,0 +1,86 @@
+#pragma once
+
+// This header should be included from parquet.hpp.
+// Do not include this header directly.
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace basis_rs {
+
+/// Stable mapping between strings and dense uint32_t IDs.
+///
+/// IDs are assigned in order of first insertion, starting at 0, and never
+/// change, so one table can be shared by every DataFrame of a backtest
+/// (e.g. one table for the "symbol" column across all trading days) and the
+/// IDs used as keys of flat arrays or integer hash maps.
+///
+/// Thread-safe: lookups take a shared lock, inserting a new string an
+/// exclusive one. Strings are stored in a deque, so the views returned by
+/// Name() stay valid for the lifetime of the table.
+///
+/// Example:
+///   basis_rs::SymbolTable symbols;
+///   for (const auto& day : days) {
+///     DataFrame df(day);
+///     auto ids = df.GetInternedColumn("symbol", symbols);
+///     for (uint32_t id : ids) volume[id] += ...;
+///   }
+///   std::cout << symbols.Name(0);
+class SymbolTable {
+ public:
+  SymbolTable() = default;
+  SymbolTable(const SymbolTable&) = delete;
+  SymbolTable& operator=(const SymbolTable&) = delete;
+
+  /// ID of `name`, inserting it if it is new.
+  uint32_t Intern(std::string_view name) {
+    {
+      std::shared_lock lock(mu_);
+      if (auto it = ids_.find(name); it != ids_.end()) return it->second;
+    }
+    std::unique_lock lock(mu_);
+    if (auto it = ids_.find(name); it != ids_.end()) return it->second;
+    auto id = static_cast<uint32_t>(names_.size());
+    const auto& stored = names_.emplace_back(name);
+    ids_.emplace(stored, id);
+    return id;
+  }
+
+  /// ID of `name`, or std::nullopt if it was never interned.
+  std::optional<uint32_t> Find(std::string_view name) const {
+    std::shared_lock lock(mu_);
+    if (auto it = ids_.find(name); it != ids_.end()) return it->second;
+    return std::nullopt;
+  }
+
+  /// String of an ID. Throws std::out_of_range for unknown IDs.
+  std::string_view Name(uint32_t id) const {
+    std::shared_lock lock(mu_);
+    if (id >= names_.size()) {
+      throw std::out_of_range("SymbolTable: unknown id " + std::to_string(id));
+    }
+    return names_[id];
+  }
+
+  /// Number of distinct strings interned so far.
+  size_t size() const {
+    std::shared_lock lock(mu_);
+    return names_.size();
+  }
+
+ private:
+  mutable std::shared_mutex mu_;
+  std::deque<std::string> names_;  // Indexed by ID; elements never move
+  std::unordered_map<std::string_view, uint32_t> ids_;  // Views into names_
+};
+
+}  // namespace basis_rs
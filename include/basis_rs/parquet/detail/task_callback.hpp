@@ -0,0 +1,26 @@
+#pragma once
+
+// Included by the generated cxx_bridge.rs.h (and its .cc), so this header
+// must stay self-contained and C++17-compatible.
+
+#include <cstddef>
+
+namespace basis_rs {
+namespace ffi {
+
+/// Completion target of a background ParquetTask. The `ctx` passed to a
+/// parquet_task_* call is the address of one of these; Rust hands it back to
+/// parquet_task_complete() once the task's result is stored.
+struct TaskCallback {
+  void (*complete)(TaskCallback* self);
+};
+
+/// Called by Rust on the Polars pool thread that finished a task. `complete`
+/// must not throw; the bridge has no way to carry an exception back to Rust.
+inline void parquet_task_complete(size_t ctx) {
+  auto* callback = reinterpret_cast<TaskCallback*>(ctx);
+  callback->complete(callback);
+}
+
+}  // namespace ffi
+}  // namespace basis_rs
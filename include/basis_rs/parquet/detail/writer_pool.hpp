@@ -0,0 +1,572 @@
+#pragma once
+
+// This header should be included from parquet.hpp.
+// Do not include this header directly.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "cxx_bridge.rs.h"
+
+namespace basis_rs {
+
+class WriterPool;
+
+template <typename RecordType>
+class PooledWriter;
+
+/// Counters of a WriterPool.
+struct WriterPoolStats {
+  size_t buffered_bytes = 0;       // Accepted records not yet written
+  size_t peak_buffered_bytes = 0;  // High-water mark of buffered_bytes
+  uint64_t row_groups_written = 0;
+  uint64_t budget_flushes = 0;      // Row groups sealed early to free memory
+  uint64_t backpressure_waits = 0;  // Writes that blocked on the budget
+};
+
+namespace detail {
+
+/// Most records a PooledWriter stages before handing them to the pool.
+inline constexpr size_t kPoolBlockRecords = 4096;
+
+/// File options a WriterPool applies to the writers it opens.
+struct PoolWriterOptions {
+  std::string compression = "zstd";
+  size_t row_group_size = 100000;
+  size_t data_page_size = 0;
+  bool statistics = true;
+};
+
+/// One output file of a WriterPool. The staged records belong to the
+/// handle's thread; everything else except the Rust writer is guarded by the
+/// pool mutex. The Rust writer is only touched by the sink's jobs, which the
+/// pool never runs concurrently.
+class PoolSink : public std::enable_shared_from_this<PoolSink> {
+ public:
+  struct Job {
+    std::function<void()> run;
+    size_t bytes;  // Budget released when the job completes (0: footer)
+  };
+
+  PoolSink(size_t row_group_size, size_t record_bytes, size_t block_records)
+      : row_group_size(row_group_size),
+        record_bytes(record_bytes),
+        block_records(block_records) {}
+
+  virtual ~PoolSink() = default;
+
+  /// Move the buffered records into a job that encodes them as a row group.
+  virtual std::function<void()> SealBuffer() = 0;
+
+  /// Job that writes the footer and closes the file.
+  virtual std::function<void()> FinishJob() = 0;
+
+  virtual size_t BufferSize() const = 0;
+
+  virtual size_t StagedRecords() const = 0;
+
+  /// Move the first `count` staged records to the end of the buffer.
+  virtual void MoveStaged(size_t count) = 0;
+
+  const size_t row_group_size;
+  const size_t record_bytes;   // sizeof(RecordType)
+  const size_t block_records;  // Staged records per hand-off
+
+  std::deque<Job> jobs;       // Sealed work, run in order
+  size_t buffered_bytes = 0;  // Budget held by the unsealed buffer
+  bool queued = false;        // In the pool's ready queue or running
+  std::atomic<bool> closed{false};  // Also read by the handle, unlocked
+};
+
+template <typename RecordType>
+class PoolSinkOf final : public PoolSink {
+ public:
+  PoolSinkOf(std::filesystem::path path, PoolWriterOptions options,
+             size_t block_records)
+      : PoolSink(options.row_group_size, sizeof(RecordType), block_records),
+        path_(std::move(path)),
+        options_(std::move(options)) {}
+
+  std::function<void()> SealBuffer() override {
+    auto batch = std::make_shared<std::vector<RecordType>>(std::move(buffer));
+    buffer.clear();
+    return [this, batch] {
+      EnsureWriter();
+      GetParquetCodec<RecordType>().WriteAll(**writer_, *batch);
+      ffi::parquet_writer_write_batch(**writer_);
+    };
+  }
+
+  std::function<void()> FinishJob() override {
+    return [this] {
+      if (writer_) ffi::parquet_writer_finish(std::move(*writer_));
+      writer_.reset();
+    };
+  }
+
+  size_t BufferSize() const override { return buffer.size(); }
+
+  size_t StagedRecords() const override { return staged.size(); }
+
+  void MoveStaged(size_t count) override {
+    auto end = staged.begin() + static_cast<ptrdiff_t>(count);
+    buffer.insert(buffer.end(), std::make_move_iterator(staged.begin()),
+                  std::make_move_iterator(end));
+    staged.erase(staged.begin(), end);
+  }
+
+  std::vector<RecordType> buffer;  // Charged to the budget, not yet sealed
+  std::vector<RecordType> staged;  // Written by the handle without the lock
+
+ private:
+  void EnsureWriter() {
+    if (!writer_) {
+      writer_ = std::make_unique<rust::Box<ffi::ParquetWriter>>(
+          ffi::parquet_writer_new(path_.string(), options_.compression,
+                                  options_.row_group_size));
+      ffi::parquet_writer_set_data_page_size(**writer_,
+                                             options_.data_page_size);
+      ffi::parquet_writer_set_statistics(**writer_, options_.statistics);
+    }
+  }
+
+  std::filesystem::path path_;
+  PoolWriterOptions options_;
+  std::unique_ptr<rust::Box<ffi::ParquetWriter>> writer_;
+};
+
+}  // namespace detail
+
+/// Many concurrent output files on a shared encoding pool.
+///
+/// Opening hundreds of ParquetWriter<T>s makes each one encode on its
+/// caller's thread and hold its own buffers. A WriterPool instead owns a
+/// fixed set of encoding threads and one memory budget for all of its files:
+///
+/// - Open<T>() hands out PooledWriter<T> handles that only buffer records;
+///   full row groups are transposed, encoded and written by the pool threads.
+///   Row groups of one file are written in order, one at a time.
+/// - Buffered and in-flight records count against the budget
+///   (sizeof(RecordType) per record; heap storage of string members is not
+///   counted). When a write would exceed it, the pool seals the largest
+///   buffers first as early row groups, and the writing thread blocks until
+///   enough of them have been written (backpressure).
+/// - Each handle stages up to 4096 records (at most 1/64 of the budget)
+///   without locking and hands them to the pool in one step, so writers on
+///   different threads only contend on the pool once per block. Staged
+///   records are charged to the budget when they are handed over.
+///
+/// Handles must not outlive the pool. Encoding errors are reported by
+/// Finish().
+///
+/// Example:
+///   basis_rs::WriterPool pool(8, size_t{2} << 30);  // 8 threads, 2 GiB
+///   pool.WithRowGroupSize(200000);
+///   std::map<int, basis_rs::PooledWriter<Trade>> parts;
+///   for (const auto& t : trades) {
+///     auto it = parts.find(t.day);
+///     if (it == parts.end()) {
+///       it = parts.emplace(t.day, pool.Open<Trade>(PathFor(t.day))).first;
+///     }
+///     it->second.WriteRecord(t);
+///   }
+///   parts.clear();  // closes every file
+///   pool.Finish();  // waits for the writes, rethrows the first error
+class WriterPool {
+ public:
+  /// Start `threads` encoding threads sharing `memory_budget` bytes.
+  explicit WriterPool(
+      size_t threads = std::max(1u, std::thread::hardware_concurrency()),
+      size_t memory_budget = size_t{1} << 30)
+      : budget_(memory_budget) {
+    workers_.reserve(std::max<size_t>(threads, 1));
+    for (size_t i = 0; i < std::max<size_t>(threads, 1); ++i) {
+      workers_.emplace_back([this] { WorkerLoop(); });
+    }
+  }
+
+  // Handles and worker threads point back at the pool
+  WriterPool(const WriterPool&) = delete;
+  WriterPool& operator=(const WriterPool&) = delete;
+
+  /// Destructor closes open files and waits for pending writes (best-effort,
+  /// exceptions swallowed). Call Finish() explicitly to handle errors.
+  ~WriterPool() {
+    try {
+      Finish();
+    } catch (...) {
+    }
+    {
+      std::lock_guard lock(mu_);
+      stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) worker.join();
+  }
+
+  /// Compression for files opened afterwards (default: "zstd").
+  WriterPool& WithCompression(std::string compression) {
+    options_.compression = std::move(compression);
+    return *this;
+  }
+
+  /// Rows per row group for files opened afterwards (default: 100K).
+  WriterPool& WithRowGroupSize(size_t size) {
+    options_.row_group_size = std::max<size_t>(size, 1);
+    return *this;
+  }
+
+  /// See ParquetWriter::WithDataPageSize().
+  WriterPool& WithDataPageSize(size_t bytes) {
+    options_.data_page_size = bytes;
+    return *this;
+  }
+
+  /// See ParquetWriter::WithStatistics().
+  WriterPool& WithStatistics(bool enabled) {
+    options_.statistics = enabled;
+    return *this;
+  }
+
+  /// Open a file on the pool. The file is not created until its first row
+  /// group is written. Thread-safe.
+  template <typename RecordType>
+  PooledWriter<RecordType> Open(std::filesystem::path path) {
+    const size_t block = std::clamp<size_t>(
+        budget_ / (64 * sizeof(RecordType)), 1,
+        std::min(detail::kPoolBlockRecords, options_.row_group_size));
+    std::lock_guard lock(mu_);
+    auto sink = std::make_shared<detail::PoolSinkOf<RecordType>>(
+        std::move(path), options_, block);
+    sinks_.push_back(sink);
+    return PooledWriter<RecordType>(this, std::move(sink));
+  }
+
+  /// Close every open file, wait until all row groups and footers are
+  /// written, and rethrow the first encoding or I/O error. Handles still
+  /// alive are closed (with their staged records); writing to them
+  /// afterwards throws std::logic_error. Must not run concurrently with
+  /// writes to handles that are still open.
+  void Finish() {
+    std::unique_lock lock(mu_);
+    for (auto& sink : sinks_) CloseLocked(*sink);
+    sinks_.clear();
+    idle_cv_.wait(lock, [this] { return ready_.empty() && running_ == 0; });
+    if (error_) std::rethrow_exception(std::exchange(error_, nullptr));
+  }
+
+  WriterPoolStats Stats() const {
+    std::lock_guard lock(mu_);
+    return stats_;
+  }
+
+ private:
+  template <typename RecordType>
+  friend class PooledWriter;
+
+  /// Charge the records staged by `sink`'s handle to the budget and move
+  /// them into its buffer.
+  void HandOff(detail::PoolSink& sink) {
+    std::unique_lock lock(mu_);
+    HandOffLocked(lock, sink);
+  }
+
+  /// Hand off the staged records, then buffer `records` in chunks of at
+  /// most one row group, reserving budget per chunk.
+  template <typename RecordType>
+  void Append(detail::PoolSinkOf<RecordType>& sink,
+              std::span<const RecordType> records) {
+    std::unique_lock lock(mu_);
+    HandOffLocked(lock, sink);
+    while (!records.empty()) {
+      size_t take = std::min(records.size(),
+                             sink.row_group_size - sink.buffer.size());
+      ReserveOpen(lock, sink, take * sizeof(RecordType));
+      sink.buffer.insert(sink.buffer.end(), records.begin(),
+                         records.begin() + static_cast<ptrdiff_t>(take));
+      sink.buffered_bytes += take * sizeof(RecordType);
+      records = records.subspan(take);
+      if (sink.buffer.size() >= sink.row_group_size) SealLocked(sink, false);
+    }
+  }
+
+  void HandOffLocked(std::unique_lock<std::mutex>& lock,
+                     detail::PoolSink& sink) {
+    size_t bytes = sink.StagedRecords() * sink.record_bytes;
+    if (bytes == 0) return;
+    ReserveOpen(lock, sink, bytes);
+    DrainStagedLocked(sink);
+  }
+
+  // Reserve() for a write to `sink`, which must be open before and after
+  // (Finish() may close it while the write waits for budget).
+  void ReserveOpen(std::unique_lock<std::mutex>& lock, detail::PoolSink& sink,
+                   size_t bytes) {
+    if (sink.closed) ThrowClosed();
+    Reserve(lock, bytes);
+    if (sink.closed) {
+      Release(bytes);
+      ThrowClosed();
+    }
+  }
+
+  [[noreturn]] static void ThrowClosed() {
+    throw std::logic_error("PooledWriter used after its file was closed");
+  }
+
+  // Move the staged records (already charged) into the buffer, sealing
+  // each full row group.
+  void DrainStagedLocked(detail::PoolSink& sink) {
+    while (size_t staged = sink.StagedRecords()) {
+      size_t take =
+          std::min(staged, sink.row_group_size - sink.BufferSize());
+      sink.MoveStaged(take);
+      sink.buffered_bytes += take * sink.record_bytes;
+      if (sink.BufferSize() >= sink.row_group_size) SealLocked(sink, false);
+    }
+  }
+
+  void Close(detail::PoolSink& sink) {
+    std::lock_guard lock(mu_);
+    CloseLocked(sink);
+    std::erase_if(sinks_, [&](const auto& s) { return s.get() == &sink; });
+  }
+
+  size_t BufferSize(const detail::PoolSink& sink) const {
+    std::lock_guard lock(mu_);
+    return sink.BufferSize();
+  }
+
+  // Take `bytes` of budget, sealing the largest buffers and then waiting
+  // for the workers while the budget is exhausted. A write larger than the
+  // whole budget is admitted once nothing else is buffered.
+  void Reserve(std::unique_lock<std::mutex>& lock, size_t bytes) {
+    bool waited = false;
+    while (stats_.buffered_bytes > 0 &&
+           stats_.buffered_bytes + bytes > budget_) {
+      size_t excess = stats_.buffered_bytes + bytes - budget_;
+      if (in_flight_bytes_ < excess && SealLargestLocked()) {
+        ++stats_.budget_flushes;
+        continue;
+      }
+      if (!waited) ++stats_.backpressure_waits;
+      waited = true;
+      space_cv_.wait(lock);
+    }
+    Charge(bytes);
+  }
+
+  void Charge(size_t bytes) {
+    stats_.buffered_bytes += bytes;
+    stats_.peak_buffered_bytes =
+        std::max(stats_.peak_buffered_bytes, stats_.buffered_bytes);
+  }
+
+  void Release(size_t bytes) {
+    stats_.buffered_bytes -= bytes;
+    space_cv_.notify_all();
+  }
+
+  bool SealLargestLocked() {
+    detail::PoolSink* largest = nullptr;
+    for (const auto& sink : sinks_) {
+      if (sink->buffered_bytes > 0 &&
+          (!largest || sink->buffered_bytes > largest->buffered_bytes)) {
+        largest = sink.get();
+      }
+    }
+    if (!largest) return false;
+    // Budget flushes jump the queue so their memory is released first
+    SealLocked(*largest, true);
+    return true;
+  }
+
+  void SealLocked(detail::PoolSink& sink, bool urgent) {
+    if (sink.buffered_bytes == 0) return;
+    sink.jobs.push_back({sink.SealBuffer(), sink.buffered_bytes});
+    in_flight_bytes_ += sink.buffered_bytes;
+    sink.buffered_bytes = 0;
+    Schedule(sink, urgent);
+  }
+
+  // Staged records are charged without waiting for budget: closing never
+  // blocks on backpressure.
+  void CloseLocked(detail::PoolSink& sink) {
+    if (sink.closed) return;
+    Charge(sink.StagedRecords() * sink.record_bytes);
+    DrainStagedLocked(sink);
+    SealLocked(sink, false);
+    sink.jobs.push_back({sink.FinishJob(), 0});
+    sink.closed = true;
+    Schedule(sink, false);
+  }
+
+  void Schedule(detail::PoolSink& sink, bool urgent) {
+    if (sink.queued) return;
+    sink.queued = true;
+    if (urgent) {
+      ready_.push_front(sink.shared_from_this());
+    } else {
+      ready_.push_back(sink.shared_from_this());
+    }
+    work_cv_.notify_one();
+  }
+
+  void WorkerLoop() {
+    std::unique_lock lock(mu_);
+    while (true) {
+      work_cv_.wait(lock, [this] { return stop_ || !ready_.empty(); });
+      if (ready_.empty()) return;
+      auto sink = std::move(ready_.front());
+      ready_.pop_front();
+      auto job = std::move(sink->jobs.front());
+      sink->jobs.pop_front();
+      ++running_;
+
+      lock.unlock();
+      std::exception_ptr error;
+      try {
+        job.run();
+      } catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+
+      --running_;
+      if (error && !error_) error_ = error;
+      if (job.bytes > 0) {
+        in_flight_bytes_ -= job.bytes;
+        ++stats_.row_groups_written;
+        Release(job.bytes);
+      }
+      // Keep the file's jobs in order: it is requeued only after this one
+      if (sink->jobs.empty()) {
+        sink->queued = false;
+      } else {
+        ready_.push_back(std::move(sink));
+        work_cv_.notify_one();
+      }
+      if (ready_.empty() && running_ == 0) idle_cv_.notify_all();
+    }
+  }
+
+  detail::PoolWriterOptions options_;
+  const size_t budget_;
+
+  mutable std::mutex mu_;
+  std::condition_variable work_cv_;   // Workers: ready_ non-empty or stop_
+  std::condition_variable space_cv_;  // Writers: budget released
+  std::condition_variable idle_cv_;   // Finish(): all work done
+  std::vector<std::shared_ptr<detail::PoolSink>> sinks_;  // Open files
+  std::deque<std::shared_ptr<detail::PoolSink>> ready_;
+  size_t in_flight_bytes_ = 0;  // Sealed but not yet written
+  size_t running_ = 0;
+  WriterPoolStats stats_;
+  std::exception_ptr error_;
+  bool stop_ = false;
+  std::vector<std::thread> workers_;
+};
+
+/// Lightweight handle to one file of a WriterPool.
+///
+/// Writes only buffer records; encoding and I/O happen on the pool. Records
+/// are staged in the handle and handed to the pool a block at a time, so
+/// most writes take no lock. A handle must be used by one thread at a time,
+/// but different handles may be used from different threads.
+template <typename RecordType>
+class PooledWriter {
+ public:
+  PooledWriter(PooledWriter&& other) noexcept
+      : pool_(std::exchange(other.pool_, nullptr)),
+        sink_(std::move(other.sink_)) {}
+
+  PooledWriter& operator=(PooledWriter&& other) noexcept {
+    if (this != &other) {
+      CloseQuietly();
+      pool_ = std::exchange(other.pool_, nullptr);
+      sink_ = std::move(other.sink_);
+    }
+    return *this;
+  }
+
+  /// Destructor closes the file (see Close()).
+  ~PooledWriter() { CloseQuietly(); }
+
+  /// Buffer a record. The write that completes a block blocks while the
+  /// pool's memory budget is exhausted.
+  void WriteRecord(const RecordType& record) { Emplace(record); }
+
+  void WriteRecord(RecordType&& record) { Emplace(std::move(record)); }
+
+  template <typename... Args>
+  void Emplace(Args&&... args) {
+    if (!pool_ || sink_->closed.load(std::memory_order_acquire)) {
+      throw std::logic_error("PooledWriter used after its file was closed");
+    }
+    auto& staged = sink_->staged;
+    if (staged.capacity() == 0) staged.reserve(sink_->block_records);
+    staged.emplace_back(std::forward<Args>(args)...);
+    if (staged.size() >= sink_->block_records) pool_->HandOff(*sink_);
+  }
+
+  /// Buffer records, taking the pool lock once for the whole span.
+  void WriteRecords(std::span<const RecordType> records) {
+    if (!pool_) {
+      throw std::logic_error("PooledWriter used after its file was closed");
+    }
+    pool_->Append(*sink_, records);
+  }
+
+  void WriteRecords(const std::vector<RecordType>& records) {
+    WriteRecords(std::span<const RecordType>(records));
+  }
+
+  /// Seal the buffered records as the last row group and queue the footer.
+  /// Returns without waiting; WriterPool::Finish() waits for the file to be
+  /// complete and reports errors. Safe to call more than once.
+  void Close() {
+    if (!pool_) return;
+    pool_->Close(*sink_);
+    pool_ = nullptr;
+    sink_.reset();
+  }
+
+  /// Returns the number of records buffered or staged and not yet sealed.
+  size_t BufferSize() const {
+    return pool_ ? pool_->BufferSize(*sink_) + sink_->staged.size() : 0;
+  }
+
+ private:
+  friend class WriterPool;
+
+  PooledWriter(WriterPool* pool,
+               std::shared_ptr<detail::PoolSinkOf<RecordType>> sink)
+      : pool_(pool), sink_(std::move(sink)) {}
+
+  void CloseQuietly() noexcept {
+    try {
+      Close();
+    } catch (...) {
+    }
+  }
+
+  WriterPool* pool_;
+  std::shared_ptr<detail::PoolSinkOf<RecordType>> sink_;
+};
+
+}  // namespace basis_rs
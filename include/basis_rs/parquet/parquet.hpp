@@ -38,17 +38,35 @@
  *   writer.Finish();
  */
 
+#include <algorithm>
+#include <atomic>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 // Include CXX-generated header
 #include "cxx_bridge.rs.h"
 
 // Include internal detail headers
+#include "detail/awaitable.hpp"
+#include "detail/cancellation.hpp"
 #include "detail/column_accessor.hpp"
+#include "detail/group_by.hpp"
+#include "detail/sort.hpp"
+#include "detail/symbol_table.hpp"
 #include "detail/type_traits.hpp"
 
 namespace basis_rs {
@@ -63,7 +81,112 @@ const ParquetCodec<RecordType>& GetParquetCodec();
 template <typename T>
 struct ParquetCellCodec;
 
+class DataFrame;
 class DataFrameBuilder;
+class SharedDataFrame;
+
+template <typename RecordType>
+class TypedQuery;
+
+/// Number of worker threads in the Polars global pool shared by all reads,
+/// filtered collects and writers in the process.
+///
+/// The pool is sized once, on first use, from POLARS_MAX_THREADS (default:
+/// number of cores); set the variable before any basis_rs call to tune it.
+inline size_t ThreadPoolSize() { return ffi::parquet_thread_pool_size(); }
+
+/// Non-owning, read-only view of a DataFrame.
+///
+/// DataFrameView carries the const accessors shared by DataFrame and
+/// SharedDataFrame. It is a single pointer, cheap to copy, and does not keep
+/// the data alive: the owning DataFrame or SharedDataFrame must outlive the
+/// view and every accessor obtained from it.
+///
+/// All methods only read the underlying Rust DataFrame and are safe to call
+/// concurrently from multiple threads.
+class DataFrameView {
+ public:
+  explicit DataFrameView(const ffi::ParquetDataFrame& df) : df_(&df) {}
+
+  /// Returns the number of rows in the DataFrame.
+  size_t NumRows() const { return ffi::parquet_df_num_rows(*df_); }
+
+  /// Returns the number of columns in the DataFrame.
+  size_t NumCols() const { return ffi::parquet_df_num_cols(*df_); }
+
+  /// Returns metadata for all columns (name and data type).
+  std::vector<ffi::ColumnInfo> Columns() const {
+    auto rust_vec = ffi::parquet_df_columns(*df_);
+    return std::vector<ffi::ColumnInfo>(rust_vec.begin(), rust_vec.end());
+  }
+
+  /// Get a column as a typed accessor for zero-copy iteration.
+  /// See DataFrame::GetColumn().
+  template <typename T>
+  ColumnAccessor<T> GetColumn(const std::string& name) const;
+
+  /// Get a numeric column converted to T. See DataFrame::GetColumnAs().
+  template <typename T>
+  ColumnAccessor<T> GetColumnAs(const std::string& name) const;
+
+  /// Get a string column (requires allocation due to variable-length strings).
+  std::vector<std::string> GetStringColumn(const std::string& name) const {
+    auto rust_vec = ffi::parquet_df_get_string_column(*df_, name);
+    std::vector<std::string> result;
+    result.reserve(rust_vec.size());
+    for (const auto& s : rust_vec) {
+      result.emplace_back(std::string(s));
+    }
+    return result;
+  }
+
+  /// Get a string column as IDs interned in `table`.
+  /// See DataFrame::GetInternedColumn().
+  ColumnAccessor<uint32_t> GetInternedColumn(const std::string& name,
+                                             SymbolTable& table) const {
+    auto interned = ffi::parquet_df_intern_string_column(*df_, name);
+    auto codes =
+        std::make_shared<rust::Vec<uint32_t>>(std::move(interned.codes));
+
+    // Each distinct value is hashed once to translate its local code
+    std::vector<uint32_t> ids;
+    ids.reserve(interned.uniques.size());
+    bool identity = true;
+    for (const auto& s : interned.uniques) {
+      ids.push_back(table.Intern(std::string_view(s.data(), s.size())));
+      identity &= ids.back() == ids.size() - 1;
+    }
+    if (!identity) {
+      for (auto& code : *codes) code = ids[code];
+    }
+
+    ColumnAccessor<uint32_t> accessor;
+    accessor.AddChunk(codes->data(), codes->size());
+    accessor.KeepAlive(std::move(codes));
+    return accessor;
+  }
+
+  /// Read all rows as struct records using the registered ParquetCodec.
+  /// See DataFrame::ReadAllAs().
+  template <typename RecordType>
+  std::vector<RecordType> ReadAllAs() const;
+
+  /// Project a subset of columns into a new DataFrame. See DataFrame::Select().
+  DataFrame Select(const std::vector<std::string>& names) const;
+
+  /// Gather rows by index into a new DataFrame. See DataFrame::Take().
+  DataFrame Take(std::span<const uint32_t> rows) const;
+
+  /// Keep the rows where `column op value` holds. See DataFrame::Filter().
+  template <typename V>
+  DataFrame Filter(const std::string& column, ffi::FilterOp op, V value) const;
+
+  /// Access underlying FFI handle (for advanced use)
+  const ffi::ParquetDataFrame& Handle() const { return *df_; }
+
+ private:
+  const ffi::ParquetDataFrame* df_;
+};
 
 /// Zero-copy DataFrame wrapper. Provides direct access to Parquet column data.
 ///
@@ -102,6 +225,72 @@ class DataFrame {
   ///       .Collect();
   static DataFrameBuilder Open(const std::filesystem::path& path);
 
+  /// Start a query addressed by RecordType members (see TypedQuery).
+  ///
+  /// Column names come from the registered ParquetCodec and filter literals
+  /// are type-checked against the members at compile time:
+  ///   auto trades = DataFrame::Query<Trade>("trades.parquet")
+  ///       .Where(&Trade::price, Gt, 100.0)
+  ///       .Select(&Trade::id, &Trade::price)
+  ///       .CollectAs<Trade>();
+  template <typename RecordType>
+  static TypedQuery<RecordType> Query(const std::filesystem::path& path);
+
+  /// Open a Parquet file from a coroutine without blocking its thread.
+  ///
+  /// The file is read on the Polars pool; the coroutine is resumed through
+  /// `resume` (inline on the pool thread if empty, see ResumeFn).
+  ///
+  /// Example:
+  ///   basis_rs::DataFrame df = co_await DataFrame::OpenAwait("ticks.parquet");
+  static OpenAwaitable OpenAwait(std::filesystem::path path,
+                                 ResumeFn resume = {}) {
+    return OpenAwaitable(std::move(path), std::move(resume));
+  }
+
+  /// Concatenate DataFrames vertically without copying column data.
+  ///
+  /// All inputs must have the same column names and types, in the same order.
+  /// The chunks of each input are appended to the result, so a column of the
+  /// result has (at least) one chunk per input. ColumnAccessor iterates across
+  /// them transparently; call Rechunk() if contiguous memory is required.
+  ///
+  /// Throws std::invalid_argument if `frames` is empty, and rust::Error on a
+  /// schema mismatch.
+  ///
+  /// Example:
+  ///   std::vector<DataFrame> days;
+  ///   days.emplace_back("2025/01/02.parquet");
+  ///   days.emplace_back("2025/01/03.parquet");
+  ///   auto all = DataFrame::Concat(std::move(days));
+  static DataFrame Concat(std::vector<DataFrame>&& frames) {
+    if (frames.empty()) {
+      throw std::invalid_argument("DataFrame::Concat requires at least one DataFrame");
+    }
+    DataFrame result = std::move(frames.front());
+    for (size_t i = 1; i < frames.size(); ++i) {
+      ffi::parquet_df_vstack(*result.df_, *frames[i].df_);
+    }
+    frames.clear();
+    return result;
+  }
+
+  /// Stitch the columns of two DataFrames side by side without copying.
+  ///
+  /// Both inputs must have the same number of rows, and their column names
+  /// must be distinct. The result shares column buffers with `left` and
+  /// `right`, which remain usable.
+  ///
+  /// Throws rust::Error on a row count mismatch or duplicate column name.
+  ///
+  /// Example:
+  ///   DataFrame ticks("ticks.parquet");
+  ///   DataFrame factors("factors.parquet");
+  ///   auto joined = DataFrame::HStack(ticks, factors);
+  static DataFrame HStack(const DataFrame& left, const DataFrame& right) {
+    return DataFrame(ffi::parquet_df_hstack(*left.df_, *right.df_));
+  }
+
   /// Move constructor
   DataFrame(DataFrame&&) = default;
   DataFrame& operator=(DataFrame&&) = default;
@@ -111,16 +300,13 @@ class DataFrame {
   DataFrame& operator=(const DataFrame&) = delete;
 
   /// Returns the number of rows in the DataFrame.
-  size_t NumRows() const { return ffi::parquet_df_num_rows(*df_); }
+  size_t NumRows() const { return View().NumRows(); }
 
   /// Returns the number of columns in the DataFrame.
-  size_t NumCols() const { return ffi::parquet_df_num_cols(*df_); }
+  size_t NumCols() const { return View().NumCols(); }
 
   /// Returns metadata for all columns (name and data type).
-  std::vector<ffi::ColumnInfo> Columns() const {
-    auto rust_vec = ffi::parquet_df_columns(*df_);
-    return std::vector<ffi::ColumnInfo>(rust_vec.begin(), rust_vec.end());
-  }
+  std::vector<ffi::ColumnInfo> Columns() const { return View().Columns(); }
 
   /// Rechunk all columns to have a single contiguous buffer.
   ///
@@ -138,10 +324,55 @@ class DataFrame {
   /// - Sequential iteration (range-for loops) - already optimal
   /// - Large files - rechunking allocates and copies all data (expensive)
   /// - Memory-constrained environments - doubles peak memory usage temporarily
+  ///   (use RechunkColumns() to rechunk only what you need)
   ///
   /// Returns true if rechunking was performed, false if already single-chunked.
   bool Rechunk() { return ffi::parquet_df_rechunk(*df_); }
 
+  /// Rechunk only the named columns, one column at a time.
+  ///
+  /// Each column is copied into a single buffer and its old chunks are
+  /// released before the next column starts, so peak extra memory is the
+  /// largest listed column instead of the whole DataFrame.
+  ///
+  /// Accessors obtained earlier for a rechunked column dangle afterwards;
+  /// call GetColumn() again. Accessors of other columns stay valid.
+  ///
+  /// Returns the number of columns that had multiple chunks.
+  size_t RechunkColumns(const std::vector<std::string>& names) {
+    size_t rechunked = 0;
+    for (const auto& name : names) {
+      rechunked += ffi::parquet_df_rechunk_column(*df_, name) ? 1 : 0;
+    }
+    return rechunked;
+  }
+
+  /// RechunkColumns() on a background thread (empty `names` = all columns).
+  ///
+  /// The DataFrame is moved into the task, so nothing can read it while the
+  /// columns are swapped, and the caller gets it back from the future. The
+  /// caller is not blocked in the meantime. As with RechunkColumns(),
+  /// accessors obtained earlier for a rechunked column are invalidated;
+  /// fetch them again from the returned DataFrame.
+  ///
+  /// Example:
+  ///   auto pending = std::move(df).RechunkAsync({"price", "volume"});
+  ///   PrepareOtherWork();
+  ///   df = pending.get();
+  ///   const double* prices = df.GetColumn<double>("price").Chunk(0).data();
+  std::future<DataFrame> RechunkAsync(std::vector<std::string> names = {}) && {
+    if (names.empty()) {
+      for (const auto& info : Columns()) {
+        names.emplace_back(std::string(info.name));
+      }
+    }
+    return std::async(std::launch::async,
+                      [df = std::move(*this), names = std::move(names)]() mutable {
+                        df.RechunkColumns(names);
+                        return std::move(df);
+                      });
+  }
+
   /// Get a column as a typed accessor for zero-copy iteration.
   ///
   /// Supported types: int32_t, int64_t, uint64_t, float, double
@@ -154,7 +385,26 @@ class DataFrame {
   ///
   /// The returned accessor is valid as long as the DataFrame exists.
   template <typename T>
-  ColumnAccessor<T> GetColumn(const std::string& name) const;
+  ColumnAccessor<T> GetColumn(const std::string& name) const {
+    return View().GetColumn<T>(name);
+  }
+
+  /// Get a numeric column as T, converting if the stored type differs.
+  ///
+  /// When the column already has type T this is GetColumn<T>() (zero-copy).
+  /// Otherwise the column is converted in one pass into a buffer owned by
+  /// the accessor: integer widening/narrowing (narrowing is range-checked),
+  /// integer or float to float/double, and double to float. DateTime
+  /// columns read as int64_t milliseconds whatever their stored unit.
+  /// Floating-point columns cannot be read as integers.
+  ///
+  /// Example:
+  ///   // Vendor A stores price as float32, vendor B as float64
+  ///   auto prices = df.GetColumnAs<double>("price");
+  template <typename T>
+  ColumnAccessor<T> GetColumnAs(const std::string& name) const {
+    return View().GetColumnAs<T>(name);
+  }
 
   /// Get a string column (requires allocation due to variable-length strings).
   ///
@@ -162,13 +412,26 @@ class DataFrame {
   ///   auto symbols = df.GetStringColumn("symbol");
   ///   for (const auto& s : symbols) { std::cout << s << "\n"; }
   std::vector<std::string> GetStringColumn(const std::string& name) const {
-    auto rust_vec = ffi::parquet_df_get_string_column(*df_, name);
-    std::vector<std::string> result;
-    result.reserve(rust_vec.size());
-    for (const auto& s : rust_vec) {
-      result.emplace_back(std::string(s));
-    }
-    return result;
+    return View().GetStringColumn(name);
+  }
+
+  /// Get a string column as uint32_t IDs interned in `table`.
+  ///
+  /// Rust dictionary-encodes the column in one pass and returns each
+  /// distinct string once; only those are hashed into the table, and the
+  /// per-row codes are translated in place. The IDs live in a buffer owned
+  /// by the accessor, so it stays valid independently of the DataFrame.
+  /// Reusing one table across files gives consistent IDs, turning string
+  /// joins and group-bys into integer operations. Nulls intern as "".
+  ///
+  /// Example:
+  ///   basis_rs::SymbolTable symbols;
+  ///   auto ids = df.GetInternedColumn("symbol", symbols);
+  ///   std::vector<int64_t> volume(symbols.size());
+  ///   for (size_t i = 0; i < ids.size(); ++i) volume[ids[i]] += qty[i];
+  ColumnAccessor<uint32_t> GetInternedColumn(const std::string& name,
+                                             SymbolTable& table) const {
+    return View().GetInternedColumn(name, table);
   }
 
   /// Read all rows as struct records using the registered ParquetCodec.
@@ -182,14 +445,62 @@ class DataFrame {
   ///
   /// For zero-copy access, use GetColumn<T>() instead.
   template <typename RecordType>
-  std::vector<RecordType> ReadAllAs() const;
+  std::vector<RecordType> ReadAllAs() const {
+    return View().ReadAllAs<RecordType>();
+  }
+
+  /// Project a subset of columns into a new DataFrame without touching disk.
+  ///
+  /// The result shares column buffers with this DataFrame (zero-copy).
+  ///
+  /// Example:
+  ///   DataFrame day("2025/01/02.parquet");
+  ///   auto prices = day.Select({"StockId", "Close"});
+  DataFrame Select(const std::vector<std::string>& names) const {
+    return View().Select(names);
+  }
+
+  /// Gather rows by index into a new DataFrame: row i of the result is row
+  /// rows[i] of this one. All columns (strings included) are copied by
+  /// Polars in parallel; this DataFrame is left unchanged.
+  ///
+  /// Throws rust::Error if an index is out of bounds.
+  ///
+  /// Example:
+  ///   auto order = basis_rs::ArgSort(day.GetColumn<int64_t>("StockId"),
+  ///                                  day.GetColumn<int64_t>("Timestamp"));
+  ///   auto sorted = day.Take(order);
+  DataFrame Take(std::span<const uint32_t> rows) const {
+    return View().Take(rows);
+  }
+
+  /// Keep the rows where `column op value` holds, evaluated in memory by Polars.
+  ///
+  /// Takes the same literal types as DataFrameBuilder::Filter() (int32_t,
+  /// int64_t, float, double, std::string, bool). The matching rows are copied
+  /// into a new DataFrame; this DataFrame is left unchanged.
+  ///
+  /// Example:
+  ///   auto liquid = day.Filter("Close", Gt, 10.0f);
+  template <typename V>
+  DataFrame Filter(const std::string& column, ffi::FilterOp op, V value) const {
+    return View().Filter(column, op, value);
+  }
+
+  /// Non-owning read-only view (valid as long as the DataFrame exists).
+  DataFrameView View() const { return DataFrameView(*df_); }
 
   /// Access underlying FFI handle (for advanced use)
   const ffi::ParquetDataFrame& Handle() const { return *df_; }
   ffi::ParquetDataFrame& Handle() { return *df_; }
 
  private:
+  friend class BatchQuery;
+  friend class CollectAwaitable;
   friend class DataFrameBuilder;
+  friend class DataFrameView;
+  friend class OpenAwaitable;
+  friend class SharedDataFrame;
 
   /// Private constructor from FFI handle (used by DataFrameBuilder)
   explicit DataFrame(rust::Box<ffi::ParquetDataFrame> df)
@@ -211,7 +522,7 @@ class DataFrame {
 
 // Template specializations for GetColumn
 template <>
-inline ColumnAccessor<int64_t> DataFrame::GetColumn<int64_t>(
+inline ColumnAccessor<int64_t> DataFrameView::GetColumn<int64_t>(
     const std::string& name) const {
   auto chunks = ffi::parquet_df_get_i64_chunks(*df_, name);
   ColumnAccessor<int64_t> accessor;
@@ -222,7 +533,7 @@ inline ColumnAccessor<int64_t> DataFrame::GetColumn<int64_t>(
 }
 
 template <>
-inline ColumnAccessor<int32_t> DataFrame::GetColumn<int32_t>(
+inline ColumnAccessor<int32_t> DataFrameView::GetColumn<int32_t>(
     const std::string& name) const {
   auto chunks = ffi::parquet_df_get_i32_chunks(*df_, name);
   ColumnAccessor<int32_t> accessor;
@@ -233,7 +544,7 @@ inline ColumnAccessor<int32_t> DataFrame::GetColumn<int32_t>(
 }
 
 template <>
-inline ColumnAccessor<uint64_t> DataFrame::GetColumn<uint64_t>(
+inline ColumnAccessor<uint64_t> DataFrameView::GetColumn<uint64_t>(
     const std::string& name) const {
   auto chunks = ffi::parquet_df_get_u64_chunks(*df_, name);
   ColumnAccessor<uint64_t> accessor;
@@ -244,7 +555,7 @@ inline ColumnAccessor<uint64_t> DataFrame::GetColumn<uint64_t>(
 }
 
 template <>
-inline ColumnAccessor<double> DataFrame::GetColumn<double>(
+inline ColumnAccessor<double> DataFrameView::GetColumn<double>(
     const std::string& name) const {
   auto chunks = ffi::parquet_df_get_f64_chunks(*df_, name);
   ColumnAccessor<double> accessor;
@@ -255,7 +566,7 @@ inline ColumnAccessor<double> DataFrame::GetColumn<double>(
 }
 
 template <>
-inline ColumnAccessor<float> DataFrame::GetColumn<float>(
+inline ColumnAccessor<float> DataFrameView::GetColumn<float>(
     const std::string& name) const {
   auto chunks = ffi::parquet_df_get_f32_chunks(*df_, name);
   ColumnAccessor<float> accessor;
@@ -275,7 +586,7 @@ inline ColumnAccessor<float> DataFrame::GetColumn<float>(
 ///     auto seconds = ms / 1000;
 ///     // Convert to your preferred time representation
 ///   }
-inline ColumnAccessor<int64_t> GetDateTimeColumn(const DataFrame& df,
+inline ColumnAccessor<int64_t> GetDateTimeColumn(const DataFrameView& df,
                                                   const std::string& name) {
   auto chunks = ffi::parquet_df_get_datetime_chunks(df.Handle(), name);
   ColumnAccessor<int64_t> accessor;
@@ -285,12 +596,169 @@ inline ColumnAccessor<int64_t> GetDateTimeColumn(const DataFrame& df,
   return accessor;
 }
 
+inline ColumnAccessor<int64_t> GetDateTimeColumn(const DataFrame& df,
+                                                  const std::string& name) {
+  return GetDateTimeColumn(df.View(), name);
+}
+
+template <typename T>
+ColumnAccessor<T> DataFrameView::GetColumnAs(const std::string& name) const {
+  static_assert(std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+                    std::is_same_v<T, uint64_t> || std::is_same_v<T, float> ||
+                    std::is_same_v<T, double>,
+                "GetColumnAs supports int32_t, int64_t, uint64_t, float and double");
+
+  // Zero-copy when the stored type is T, one conversion pass otherwise
+  auto from = [&]<typename From>(ColumnAccessor<From> col, int64_t divisor = 1) {
+    if constexpr (std::is_same_v<From, T>) {
+      if (divisor == 1) return col;
+    }
+    return detail::ConvertColumn<T>(col, divisor);
+  };
+
+  switch (ffi::parquet_df_column_type(*df_, name)) {
+    case ffi::ColumnType::Int64:
+      return from(GetColumn<int64_t>(name));
+    case ffi::ColumnType::Int32:
+      return from(GetColumn<int32_t>(name));
+    case ffi::ColumnType::UInt64:
+      return from(GetColumn<uint64_t>(name));
+    case ffi::ColumnType::Float64:
+      return from(GetColumn<double>(name));
+    case ffi::ColumnType::Float32:
+      return from(GetColumn<float>(name));
+    case ffi::ColumnType::DateTime:
+      return from(GetDateTimeColumn(*this, name),
+                  ffi::parquet_df_datetime_units_per_ms(*df_, name));
+    default:
+      throw std::invalid_argument("GetColumnAs: column '" + name +
+                                  "' is not numeric");
+  }
+}
+
+/// Copyable, thread-safe handle to an immutable DataFrame.
+///
+/// SharedDataFrame is backed by an Arc on the Rust side: copying a handle only
+/// increments a reference count, and the data is released when the last
+/// handle is destroyed. Use it to fan one day of data out to worker threads
+/// instead of wrapping DataFrame in a std::shared_ptr.
+///
+/// Thread safety: all const methods, and the views and accessors they return,
+/// only read the underlying data and may be called concurrently from any
+/// number of threads. Accessors stay valid as long as any handle to the same
+/// DataFrame is alive. A single handle object follows the usual value-type
+/// rules: do not assign to it while another thread reads it; give each thread
+/// its own copy instead.
+///
+/// Example:
+///   basis_rs::SharedDataFrame day(basis_rs::DataFrame("2025/01/02.parquet"));
+///   std::vector<std::thread> workers;
+///   for (const auto& name : {"Open", "Close", "High", "Low"}) {
+///     workers.emplace_back([day, name] {  // each thread copies the handle
+///       double sum = 0;
+///       for (float v : day.GetColumn<float>(name)) sum += v;
+///     });
+///   }
+class SharedDataFrame {
+ public:
+  /// Take ownership of a DataFrame and share it. No column data is copied.
+  explicit SharedDataFrame(DataFrame&& df)
+      : shared_(ffi::parquet_df_into_shared(std::move(df.df_))) {}
+
+  SharedDataFrame(const SharedDataFrame& other)
+      : shared_(ffi::parquet_shared_df_clone(*other.shared_)) {}
+
+  SharedDataFrame& operator=(const SharedDataFrame& other) {
+    if (this != &other) {
+      shared_ = ffi::parquet_shared_df_clone(*other.shared_);
+    }
+    return *this;
+  }
+
+  SharedDataFrame(SharedDataFrame&&) = default;
+  SharedDataFrame& operator=(SharedDataFrame&&) = default;
+
+  /// Returns the number of rows in the DataFrame.
+  size_t NumRows() const { return View().NumRows(); }
+
+  /// Returns the number of columns in the DataFrame.
+  size_t NumCols() const { return View().NumCols(); }
+
+  /// Returns metadata for all columns (name and data type).
+  std::vector<ffi::ColumnInfo> Columns() const { return View().Columns(); }
+
+  /// Get a column as a typed accessor for zero-copy iteration.
+  /// See DataFrame::GetColumn().
+  template <typename T>
+  ColumnAccessor<T> GetColumn(const std::string& name) const {
+    return View().GetColumn<T>(name);
+  }
+
+  /// See DataFrame::GetColumnAs().
+  template <typename T>
+  ColumnAccessor<T> GetColumnAs(const std::string& name) const {
+    return View().GetColumnAs<T>(name);
+  }
+
+  /// Get a string column (requires allocation due to variable-length strings).
+  std::vector<std::string> GetStringColumn(const std::string& name) const {
+    return View().GetStringColumn(name);
+  }
+
+  /// See DataFrame::GetInternedColumn().
+  ColumnAccessor<uint32_t> GetInternedColumn(const std::string& name,
+                                             SymbolTable& table) const {
+    return View().GetInternedColumn(name, table);
+  }
+
+  /// Read all rows as struct records using the registered ParquetCodec.
+  template <typename RecordType>
+  std::vector<RecordType> ReadAllAs() const {
+    return View().ReadAllAs<RecordType>();
+  }
+
+  /// Project a subset of columns into a new DataFrame (zero-copy).
+  DataFrame Select(const std::vector<std::string>& names) const {
+    return View().Select(names);
+  }
+
+  /// Gather rows by index into a new DataFrame (rows are copied).
+  DataFrame Take(std::span<const uint32_t> rows) const {
+    return View().Take(rows);
+  }
+
+  /// Keep the rows where `column op value` holds, evaluated in memory.
+  template <typename V>
+  DataFrame Filter(const std::string& column, ffi::FilterOp op, V value) const {
+    return View().Filter(column, op, value);
+  }
+
+  /// Non-owning read-only view (valid as long as this handle exists).
+  DataFrameView View() const {
+    return DataFrameView(ffi::parquet_shared_df_get(*shared_));
+  }
+
+  /// Access underlying FFI handle (for advanced use)
+  const ffi::ParquetDataFrame& Handle() const {
+    return ffi::parquet_shared_df_get(*shared_);
+  }
+
+ private:
+  rust::Box<ffi::SharedParquetDataFrame> shared_;
+};
+
+inline ColumnAccessor<int64_t> GetDateTimeColumn(const SharedDataFrame& df,
+                                                  const std::string& name) {
+  return GetDateTimeColumn(df.View(), name);
+}
+
 }  // namespace basis_rs
 
 // Include remaining detail headers that depend on DataFrame
 #include "detail/cell_codec.hpp"
 #include "detail/codec.hpp"
 #include "detail/query.hpp"
+#include "detail/writer_pool.hpp"
 
 namespace basis_rs {
 
@@ -300,8 +768,20 @@ inline DataFrameBuilder DataFrame::Open(const std::filesystem::path& path) {
   return DataFrameBuilder(path);
 }
 
+template <typename RecordType>
+TypedQuery<RecordType> DataFrame::Query(const std::filesystem::path& path) {
+  return TypedQuery<RecordType>(path);
+}
+
+template <typename RecordType>
+DataFrame TypedQuery<RecordType>::Collect() const {
+  DataFrameBuilder builder = builder_;
+  builder.Select(Projection());
+  return builder.Collect();
+}
+
 inline DataFrame DataFrameBuilder::Collect() const {
-  if (filter_entries_.empty()) {
+  if (filter_entries_.empty() && !cancel_) {
     // No filters - use simple open
     if (select_names_.empty()) {
       return DataFrame(ffi::parquet_open(path_.string()));
@@ -315,13 +795,20 @@ inline DataFrame DataFrameBuilder::Collect() const {
     }
   }
 
-  // Has filters - use query API
+  // Has filters - use query API. Project only if the user explicitly
+  // selected columns; otherwise read all columns.
+  return detail::TranslateCancellation([&] {
+    return DataFrame(ffi::parquet_query_collect_df(BuildQuery(select_names_)));
+  });
+}
+
+inline rust::Box<ffi::ParquetQuery> DataFrameBuilder::BuildQuery(
+    const std::vector<std::string>& columns) const {
   auto query = ffi::parquet_query_new(path_.string());
 
-  // Set projection only if user explicitly selected columns
-  if (!select_names_.empty()) {
+  if (!columns.empty()) {
     // Include filter columns in projection to ensure filter works
-    std::vector<std::string> scan_columns = select_names_;
+    std::vector<std::string> scan_columns = columns;
     for (const auto& f : filter_entries_) {
       if (std::find(scan_columns.begin(), scan_columns.end(), f.column) ==
           scan_columns.end()) {
@@ -336,19 +823,111 @@ inline DataFrame DataFrameBuilder::Collect() const {
     }
     ffi::parquet_query_select(*query, std::move(cols));
   }
-  // If no Select() was called, read all columns (no projection)
 
   // Apply filters
   for (const auto& f : filter_entries_) {
     f.apply(*query);
   }
 
-  // Collect into DataFrame
+  if (cancel_) {
+    ffi::parquet_query_set_cancel_token(*query, cancel_->Handle());
+  }
+
+  return query;
+}
+
+template <typename Fn>
+void DataFrameBuilder::ForEachBatchFrame(const std::vector<std::string>& columns,
+                                         Fn&& fn) const {
+  auto reader = ffi::parquet_query_batches(BuildQuery(columns));
+  size_t num_batches = ffi::parquet_batch_reader_num_batches(*reader);
+  for (size_t i = 0; i < num_batches; ++i) {
+    DataFrame batch = detail::TranslateCancellation(
+        [&] { return DataFrame(ffi::parquet_batch_reader_read(*reader, i)); });
+    fn(batch.View());
+  }
+}
+
+template <typename RecordType, typename Fn>
+void DataFrameBuilder::ForEachRecords(size_t batch_rows, Fn&& fn) const {
+  const auto& codec = GetParquetCodec<RecordType>();
+  const auto& columns =
+      select_names_.empty() ? codec.column_names() : select_names_;
+
+  std::vector<RecordType> buffer;
+  ForEachBatchFrame(columns, [&](const DataFrameView& batch) {
+    codec.ForEachBatch(batch, columns, batch_rows, buffer, fn);
+  });
+}
+
+inline CollectAwaitable DataFrameBuilder::CollectAwait(ResumeFn resume) const {
+  return CollectAwaitable(BuildQuery(select_names_), std::move(resume));
+}
+
+inline DataFrame OpenAwaitable::await_resume() {
+  return DataFrame(ffi::parquet_task_take_frame(Task()));
+}
+
+inline DataFrame CollectAwaitable::await_resume() {
+  return detail::TranslateCancellation(
+      [&] { return DataFrame(ffi::parquet_task_take_frame(Task())); });
+}
+
+inline std::map<int64_t, DataFrame> BatchQuery::Collect() const {
+  rust::Vec<rust::String> paths;
+  paths.reserve(paths_.size());
+  for (const auto& path : paths_) {
+    paths.push_back(rust::String(path.string()));
+  }
+  rust::Vec<rust::String> cols;
+  cols.reserve(select_names_.size());
+  for (const auto& name : select_names_) {
+    cols.push_back(rust::String(name));
+  }
+
+  auto result = ffi::parquet_batch_query(
+      std::move(paths), key_column_,
+      rust::Slice<const int64_t>(keys_.data(), keys_.size()), std::move(cols));
+
+  std::map<int64_t, DataFrame> frames;
+  size_t num_keys = ffi::parquet_batch_query_num_keys(*result);
+  for (size_t i = 0; i < num_keys; ++i) {
+    frames.emplace(ffi::parquet_batch_query_key(*result, i),
+                   DataFrame(ffi::parquet_batch_query_frame(*result, i)));
+  }
+  return frames;
+}
+
+inline DataFrame DataFrameView::Select(
+    const std::vector<std::string>& names) const {
+  rust::Vec<rust::String> cols;
+  cols.reserve(names.size());
+  for (const auto& c : names) {
+    cols.push_back(rust::String(c));
+  }
+  return DataFrame(ffi::parquet_df_select(*df_, std::move(cols)));
+}
+
+inline DataFrame DataFrameView::Take(std::span<const uint32_t> rows) const {
+  return DataFrame(ffi::parquet_df_take(
+      *df_, rust::Slice<const uint32_t>(rows.data(), rows.size())));
+}
+
+template <typename V>
+DataFrame DataFrameView::Filter(const std::string& column, ffi::FilterOp op,
+                                V value) const {
+  auto query = ffi::parquet_query_from_df(*df_);
+  if constexpr (std::is_convertible_v<V, std::string_view>) {
+    // String literals would otherwise convert to bool ahead of std::string
+    ApplyFilter(*query, column, op, std::string(value));
+  } else {
+    ApplyFilter(*query, column, op, value);
+  }
   return DataFrame(ffi::parquet_query_collect_df(std::move(query)));
 }
 
 template <typename RecordType>
-std::vector<RecordType> DataFrame::ReadAllAs() const {
+std::vector<RecordType> DataFrameView::ReadAllAs() const {
   const auto& codec = GetParquetCodec<RecordType>();
   return codec.ReadAllFromDf(*this);
 }
@@ -398,6 +977,8 @@ class ParquetWriter {
         buffer_(std::move(other.buffer_)),
         compression_(std::move(other.compression_)),
         row_group_size_(other.row_group_size_),
+        data_page_size_(other.data_page_size_),
+        statistics_(other.statistics_),
         writer_(std::move(other.writer_)),
         finalized_(other.finalized_) {
     other.finalized_ = true;
@@ -405,6 +986,7 @@ class ParquetWriter {
 
   /// Destructor attempts best-effort flush. Exceptions are silently swallowed
   /// because destructors must be noexcept. Call Finish() explicitly to handle errors.
+  /// A destructor running during a FlushAwait() writes nothing.
   ~ParquetWriter() {
     if (!finalized_ && (!buffer_.empty() || writer_)) {
       try {
@@ -434,9 +1016,35 @@ class ParquetWriter {
   ///
   /// Recommendation: Use 100K-500K for balanced performance and file size.
   ///
+  /// The record buffer is reserved to this size up front and keeps its
+  /// capacity across flushes, so buffering never reallocates.
+  ///
   /// Returns *this for method chaining.
   ParquetWriter& WithRowGroupSize(size_t size) {
     row_group_size_ = size;
+    buffer_.reserve(size);
+    return *this;
+  }
+
+  /// Set the target data page size in bytes (0 = Polars default, ~1 MiB).
+  ///
+  /// Smaller pages give finer-grained units inside a column chunk at some
+  /// cost in compression. Must be set before the first flush.
+  ///
+  /// Returns *this for method chaining.
+  ParquetWriter& WithDataPageSize(size_t bytes) {
+    data_page_size_ = bytes;
+    return *this;
+  }
+
+  /// Enable or disable min/max/null-count statistics (default: enabled).
+  ///
+  /// Statistics let filtered reads skip row groups whose value range cannot
+  /// match. Must be set before the first flush.
+  ///
+  /// Returns *this for method chaining.
+  ParquetWriter& WithStatistics(bool enabled) {
+    statistics_ = enabled;
     return *this;
   }
 
@@ -449,15 +1057,82 @@ class ParquetWriter {
     MaybeFlush();
   }
 
-  /// Write multiple records to the buffer.
+  /// Move a record into the buffer (avoids copying string members).
+  void WriteRecord(RecordType&& record) {
+    buffer_.push_back(std::move(record));
+    MaybeFlush();
+  }
+
+  /// Construct a record in place in the buffer.
   ///
-  /// More efficient than calling WriteRecord() in a loop.
-  /// May trigger multiple automatic flushes if row_group_size is configured.
-  void WriteRecords(const std::vector<RecordType>& records) {
-    buffer_.insert(buffer_.end(), records.begin(), records.end());
+  /// Example:
+  ///   writer.Emplace(1, "alice", 85.5);
+  template <typename... Args>
+  void Emplace(Args&&... args) {
+    buffer_.emplace_back(std::forward<Args>(args)...);
     MaybeFlush();
   }
 
+  /// Write multiple records from contiguous memory.
+  ///
+  /// With row_group_size configured, whole row groups are encoded directly
+  /// from `records` without being copied into the buffer: a partially
+  /// filled buffer is topped up first (to keep row order), then each full
+  /// row group is written in place, and only the tail remainder is
+  /// buffered. Without row_group_size, records are buffered until Finish().
+  void WriteRecords(std::span<const RecordType> records) {
+    if (row_group_size_ == 0) {
+      buffer_.insert(buffer_.end(), records.begin(), records.end());
+      return;
+    }
+
+    // A smaller WithRowGroupSize() may leave the buffer already full
+    MaybeFlush();
+    if (!buffer_.empty()) {
+      size_t take = std::min(row_group_size_ - buffer_.size(), records.size());
+      buffer_.insert(buffer_.end(), records.begin(), records.begin() + take);
+      records = records.subspan(take);
+      MaybeFlush();
+    }
+
+    while (records.size() >= row_group_size_) {
+      EncodeBatch(records.first(row_group_size_));
+      records = records.subspan(row_group_size_);
+    }
+
+    buffer_.insert(buffer_.end(), records.begin(), records.end());
+  }
+
+  void WriteRecords(const std::vector<RecordType>& records) {
+    WriteRecords(std::span<const RecordType>(records));
+  }
+
+  /// Write records from any input range (e.g. std::deque, a view pipeline).
+  ///
+  /// Contiguous ranges of RecordType take the span path above; other ranges
+  /// are appended record by record, moving elements out of rvalue ranges.
+  template <std::ranges::input_range Range>
+    requires std::constructible_from<RecordType,
+                                     std::ranges::range_reference_t<Range>>
+  void WriteRecords(Range&& records) {
+    if constexpr (std::ranges::contiguous_range<Range> &&
+                  std::ranges::sized_range<Range> &&
+                  std::is_same_v<std::ranges::range_value_t<Range>,
+                                 RecordType>) {
+      WriteRecords(std::span<const RecordType>(std::ranges::data(records),
+                                               std::ranges::size(records)));
+    } else {
+      for (auto&& record : records) {
+        if constexpr (std::is_rvalue_reference_v<Range&&>) {
+          buffer_.emplace_back(std::move(record));
+        } else {
+          buffer_.emplace_back(record);
+        }
+        MaybeFlush();
+      }
+    }
+  }
+
   /// Flush any buffered records and finalize the Parquet file.
   ///
   /// This writes the Parquet footer and closes the file. After calling Finish(),
@@ -467,8 +1142,11 @@ class ParquetWriter {
   ///
   /// Always call Finish() explicitly to handle potential I/O errors. The destructor
   /// calls Finish() as a fallback, but swallows exceptions.
+  ///
+  /// Throws std::logic_error while a FlushAwait() is in flight.
   void Finish() {
     if (finalized_) return;
+    CheckNotFlushing();
     if (!buffer_.empty()) FlushBatch();
     if (writer_) ffi::parquet_writer_finish(std::move(*writer_));
     writer_.reset();
@@ -479,7 +1157,10 @@ class ParquetWriter {
   ///
   /// This abandons any buffered data and marks the writer as finalized.
   /// Use this to cancel a write operation without creating a file.
+  ///
+  /// Throws std::logic_error while a FlushAwait() is in flight.
   void Discard() {
+    CheckNotFlushing();
     buffer_.clear();
     writer_.reset();
     finalized_ = true;
@@ -488,6 +1169,29 @@ class ParquetWriter {
   /// Returns the number of records currently buffered in memory.
   size_t BufferSize() const { return buffer_.size(); }
 
+  /// Flush the buffered records as a row group from a coroutine.
+  ///
+  /// Records are transposed into columns on the calling thread; encoding,
+  /// compression and file I/O run on the Polars pool while the coroutine is
+  /// suspended. The writer must not be used, moved or destroyed until the
+  /// co_await completes: Finish(), Discard() and writes that would flush
+  /// throw std::logic_error in the meantime rather than open a new file.
+  /// Completes immediately if nothing is buffered.
+  ///
+  /// Example:
+  ///   for (auto& batch : batches) {
+  ///     writer.WriteRecords(batch);
+  ///     co_await writer.FlushAwait();
+  ///   }
+  ///   writer.Finish();
+  FlushAwaitable FlushAwait(ResumeFn resume = {}) {
+    if (buffer_.empty()) return FlushAwaitable(std::move(resume));
+    EnsureWriter();
+    GetParquetCodec<RecordType>().WriteAll(**writer_, buffer_);
+    buffer_.clear();
+    return FlushAwaitable(**writer_, flushing_, std::move(resume));
+  }
+
  private:
   void MaybeFlush() {
     if (row_group_size_ > 0 && buffer_.size() >= row_group_size_) {
@@ -495,27 +1199,48 @@ class ParquetWriter {
     }
   }
 
+  // The buffer is cleared only after a successful encode (keeping its
+  // capacity), so a failed batch stays buffered ahead of newer records.
   void FlushBatch() {
     if (buffer_.empty()) return;
+    EncodeBatch(buffer_);
+    buffer_.clear();
+  }
+
+  // Encode one batch straight from `records` as the next row group(s).
+  void EncodeBatch(std::span<const RecordType> records) {
     EnsureWriter();
-    GetParquetCodec<RecordType>().WriteAll(**writer_, buffer_);
+    GetParquetCodec<RecordType>().WriteAll(**writer_, records);
     ffi::parquet_writer_write_batch(**writer_);
-    buffer_.clear();
+  }
+
+  // While a FlushAwait() task owns the file, writer_ holds an unopened
+  // placeholder that would otherwise create (and truncate) the file again.
+  void CheckNotFlushing() const {
+    if (flushing_) {
+      throw std::logic_error("ParquetWriter: a FlushAwait() is still in flight");
+    }
   }
 
   void EnsureWriter() {
+    CheckNotFlushing();
     if (!writer_) {
       writer_ = std::make_unique<rust::Box<ffi::ParquetWriter>>(
           ffi::parquet_writer_new(path_.string(), compression_,
                                   row_group_size_));
+      ffi::parquet_writer_set_data_page_size(**writer_, data_page_size_);
+      ffi::parquet_writer_set_statistics(**writer_, statistics_);
     }
   }
 
   std::filesystem::path path_;
-  std::vector<RecordType> buffer_;
+  std::vector<RecordType> buffer_;  // Records accepted since the last flush
   std::string compression_ = "zstd";
   size_t row_group_size_ = 0;
+  size_t data_page_size_ = 0;
+  bool statistics_ = true;
   std::unique_ptr<rust::Box<ffi::ParquetWriter>> writer_;
+  bool flushing_ = false;  // A FlushAwait() task holds the writer's state
   bool finalized_ = false;
 };
 
@@ -561,6 +1286,8 @@ class ColumnarParquetWriter {
       : path_(std::move(other.path_)),
         compression_(std::move(other.compression_)),
         row_group_size_(other.row_group_size_),
+        data_page_size_(other.data_page_size_),
+        statistics_(other.statistics_),
         pending_(std::move(other.pending_)),
         writer_(std::move(other.writer_)),
         finalized_(other.finalized_) {
@@ -597,6 +1324,20 @@ class ColumnarParquetWriter {
     return *this;
   }
 
+  /// Set the target data page size in bytes (0 = Polars default).
+  /// See ParquetWriter::WithDataPageSize().
+  ColumnarParquetWriter& WithDataPageSize(size_t bytes) {
+    data_page_size_ = bytes;
+    return *this;
+  }
+
+  /// Enable or disable column statistics (default: enabled).
+  /// See ParquetWriter::WithStatistics().
+  ColumnarParquetWriter& WithStatistics(bool enabled) {
+    statistics_ = enabled;
+    return *this;
+  }
+
   /// Add an int32 column (zero-copy).
   ///
   /// The data pointer must remain valid until WriteBatch() is called.
@@ -727,15 +1468,235 @@ class ColumnarParquetWriter {
     if (!writer_) {
       writer_ = std::make_unique<rust::Box<ffi::ParquetWriter>>(
           ffi::parquet_writer_new(path_.string(), compression_, row_group_size_));
+      ffi::parquet_writer_set_data_page_size(**writer_, data_page_size_);
+      ffi::parquet_writer_set_statistics(**writer_, statistics_);
     }
   }
 
   std::filesystem::path path_;
   std::string compression_ = "zstd";
   size_t row_group_size_ = 0;
+  size_t data_page_size_ = 0;
+  bool statistics_ = true;
   std::vector<std::function<void(ffi::ParquetWriter&)>> pending_;
   std::unique_ptr<rust::Box<ffi::ParquetWriter>> writer_;
   bool finalized_ = false;
 };
 
+// ==================== ConcurrentParquetWriter ====================
+
+/// Struct-based Parquet writer fed from many threads into one file.
+///
+/// Each thread writes through its own Producer, which buffers up to one row
+/// group of records. A full buffer is transposed, encoded and compressed as
+/// a row group on the producer's own thread; only appending the finished
+/// row group to the file is serialized. Row groups are appended in the order
+/// producers sealed them, and Finish() writes the footer.
+///
+/// Rows of one producer keep their relative order. Rows of different
+/// producers are interleaved at row-group granularity, so readers that need
+/// a global order must sort (or filter on a timestamp column).
+///
+/// Example:
+///   ConcurrentParquetWriter<Tick> writer("ticks.parquet");
+///   writer.WithCompression("zstd").WithRowGroupSize(100000);
+///   std::vector<std::thread> feeds;
+///   for (auto& feed : exchange_feeds) {
+///     feeds.emplace_back([&writer, &feed] {
+///       auto producer = writer.MakeProducer();
+///       while (auto tick = feed.Next()) producer.WriteRecord(*tick);
+///       producer.Flush();  // or let the destructor flush
+///     });
+///   }
+///   for (auto& t : feeds) t.join();
+///   writer.Finish();
+template <typename RecordType>
+class ConcurrentParquetWriter {
+ public:
+  /// Per-thread handle. A Producer must only be used by one thread at a
+  /// time, and must be flushed or destroyed before the writer's Finish().
+  class Producer {
+   public:
+    Producer(Producer&& other) noexcept
+        : owner_(std::exchange(other.owner_, nullptr)),
+          stage_(std::move(other.stage_)),
+          buffer_(std::move(other.buffer_)) {}
+
+    Producer& operator=(Producer&&) = delete;
+
+    /// Destructor flushes buffered records. Its exceptions are swallowed,
+    /// but a failed row group still makes the writer's Finish() throw.
+    /// Call Flush() explicitly to handle errors where they happen.
+    ~Producer() {
+      if (!owner_) return;
+      try {
+        Flush();
+      } catch (...) {
+      }
+      owner_->active_producers_.fetch_sub(1, std::memory_order_release);
+    }
+
+    void WriteRecord(const RecordType& record) {
+      buffer_.push_back(record);
+      MaybeFlush();
+    }
+
+    void WriteRecord(RecordType&& record) {
+      buffer_.push_back(std::move(record));
+      MaybeFlush();
+    }
+
+    template <typename... Args>
+    void Emplace(Args&&... args) {
+      buffer_.emplace_back(std::forward<Args>(args)...);
+      MaybeFlush();
+    }
+
+    void WriteRecords(std::span<const RecordType> records) {
+      for (const auto& record : records) WriteRecord(record);
+    }
+
+    /// Encode the buffered records as a row group (no-op when empty) and
+    /// hand it to the sequencer.
+    void Flush() {
+      if (buffer_.empty()) return;
+      GetParquetCodec<RecordType>().WriteAll(*stage_, buffer_);
+      buffer_.clear();
+      ffi::parquet_shared_writer_encode(owner_->Shared(), *stage_);
+    }
+
+    /// Returns the number of records buffered by this producer.
+    size_t BufferSize() const { return buffer_.size(); }
+
+   private:
+    friend class ConcurrentParquetWriter;
+
+    explicit Producer(ConcurrentParquetWriter* owner)
+        : owner_(owner),
+          stage_(ffi::parquet_shared_writer_stage(owner->Shared())) {
+      buffer_.reserve(owner_->row_group_size_);
+    }
+
+    void MaybeFlush() {
+      if (buffer_.size() >= owner_->row_group_size_) Flush();
+    }
+
+    ConcurrentParquetWriter* owner_;
+    rust::Box<ffi::ParquetWriter> stage_;
+    std::vector<RecordType> buffer_;
+  };
+
+  /// Create a writer for the specified file path.
+  ///
+  /// The file is not created until the first row group is encoded.
+  /// Default compression is "zstd" with 100K-row row groups.
+  explicit ConcurrentParquetWriter(std::filesystem::path path)
+      : path_(std::move(path)) {}
+
+  // Producers point back at the writer
+  ConcurrentParquetWriter(const ConcurrentParquetWriter&) = delete;
+  ConcurrentParquetWriter& operator=(const ConcurrentParquetWriter&) = delete;
+
+  /// Destructor attempts best-effort Finish(). Exceptions are swallowed.
+  ~ConcurrentParquetWriter() {
+    if (!finalized_ && shared_) {
+      try {
+        Finish();
+      } catch (...) {
+      }
+    }
+  }
+
+  /// Set compression algorithm. See ParquetWriter::WithCompression().
+  /// Options must be set before the first MakeProducer().
+  ConcurrentParquetWriter& WithCompression(std::string compression) {
+    compression_ = std::move(compression);
+    return *this;
+  }
+
+  /// Rows per producer row group (must be > 0). Each producer buffers up to
+  /// this many records.
+  ConcurrentParquetWriter& WithRowGroupSize(size_t size) {
+    row_group_size_ = std::max<size_t>(size, 1);
+    return *this;
+  }
+
+  /// See ParquetWriter::WithDataPageSize().
+  ConcurrentParquetWriter& WithDataPageSize(size_t bytes) {
+    data_page_size_ = bytes;
+    return *this;
+  }
+
+  /// See ParquetWriter::WithStatistics().
+  ConcurrentParquetWriter& WithStatistics(bool enabled) {
+    statistics_ = enabled;
+    return *this;
+  }
+
+  /// Create a producer handle for the calling thread. Thread-safe.
+  Producer MakeProducer() {
+    active_producers_.fetch_add(1, std::memory_order_relaxed);
+    try {
+      return Producer(this);
+    } catch (...) {
+      active_producers_.fetch_sub(1, std::memory_order_relaxed);
+      throw;
+    }
+  }
+
+  /// Row groups appended to the file so far (the final count after
+  /// Finish()). Does not create the file.
+  size_t NumRowGroups() const {
+    if (finalized_) return num_row_groups_;
+    if (!shared_ready_.load(std::memory_order_acquire)) return 0;
+    return ffi::parquet_shared_writer_num_row_groups(**shared_);
+  }
+
+  /// Write the footer and close the file.
+  ///
+  /// Every producer must have been destroyed first; their remaining records
+  /// are flushed on destruction. Throws std::logic_error otherwise, or
+  /// rust::Error if a row group failed to encode or append. Subsequent
+  /// calls are no-ops.
+  void Finish() {
+    if (finalized_) return;
+    if (active_producers_.load(std::memory_order_acquire) != 0) {
+      throw std::logic_error(
+          "ConcurrentParquetWriter::Finish called with live producers");
+    }
+    finalized_ = true;
+    if (shared_) {
+      num_row_groups_ = ffi::parquet_shared_writer_num_row_groups(**shared_);
+      ffi::parquet_shared_writer_finish(std::move(*shared_));
+    }
+    shared_.reset();
+  }
+
+ private:
+  const ffi::ParquetSharedWriter& Shared() {
+    std::call_once(shared_once_, [this] {
+      shared_ = std::make_unique<rust::Box<ffi::ParquetSharedWriter>>(
+          ffi::parquet_shared_writer_new(path_.string(), compression_,
+                                         data_page_size_, statistics_));
+      shared_ready_.store(true, std::memory_order_release);
+    });
+    return **shared_;
+  }
+
+  std::filesystem::path path_;
+  std::string compression_ = "zstd";
+  size_t row_group_size_ = 100000;
+  size_t data_page_size_ = 0;
+  bool statistics_ = true;
+  std::once_flag shared_once_;
+  std::unique_ptr<rust::Box<ffi::ParquetSharedWriter>> shared_;
+  std::atomic<bool> shared_ready_{false};  // shared_ is set (NumRowGroups)
+  std::atomic<size_t> active_producers_{0};
+  size_t num_row_groups_ = 0;               // cached by Finish()
+  bool finalized_ = false;
+};
+
 }  // namespace basis_rs
+
+// Depends on ColumnarParquetWriter
+#include "detail/ingest_ring.hpp"
@@ -0,0 +1,96 @@
+//! Cooperative cancellation for long-running reads and queries.
+//!
+//! A `CancelState` is shared (via `Arc`) between the caller's token and
+//! every operation it is attached to. Operations call `check()` between
+//! units of work (one row group for a collect or a streaming batch). Polars does not expose a hook inside a running
+//! `collect()`, so a cancelled operation stops at the next unit boundary.
+
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::Mutex;
+use std::time::{Duration, Instant};
+
+/// Prefix of the error returned for cancelled work; the C++ layer maps it
+/// to `basis_rs::OperationCancelled`.
+pub const CANCELLED: &str = "Operation cancelled";
+
+#[derive(Default)]
+pub struct CancelState {
+    cancelled: AtomicBool,
+    deadline: Mutex<Option<Instant>>,
+    completed_units: AtomicU64,
+    skipped_units: AtomicU64,
+    cancelled_operations: AtomicU64,
+}
+
+impl CancelState {
+    /// Request cancellation of all attached operations.
+    pub fn cancel(&self) {
+        self.cancelled.store(true, Ordering::Release);
+    }
+
+    /// Cancel automatically once `timeout` has elapsed from now.
+    pub fn set_timeout(&self, timeout: Duration) {
+        *self.deadline.lock().unwrap() = Some(Instant::now() + timeout);
+    }
+
+    pub fn is_cancelled(&self) -> bool {
+        if self.cancelled.load(Ordering::Acquire) {
+            return true;
+        }
+        match *self.deadline.lock().unwrap() {
+            Some(deadline) => Instant::now() >= deadline,
+            None => false,
+        }
+    }
+
+    /// Fail with a cancellation error if cancelled; `remaining` units of
+    /// the operation are then counted as skipped.
+    pub fn check(&self, remaining: usize) -> Result<(), String> {
+        if !self.is_cancelled() {
+            return Ok(());
+        }
+        self.skipped_units
+            .fetch_add(remaining as u64, Ordering::Relaxed);
+        self.cancelled_operations.fetch_add(1, Ordering::Relaxed);
+        if self.cancelled.load(Ordering::Acquire) {
+            Err(CANCELLED.to_string())
+        } else {
+            Err(format!("{}: deadline exceeded", CANCELLED))
+        }
+    }
+
+    /// Count one finished unit of work.
+    pub fn record_completed(&self) {
+        self.completed_units.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// (completed units, skipped units, cancelled operations).
+    pub fn stats(&self) -> (u64, u64, u64) {
+        (
+            self.completed_units.load(Ordering::Relaxed),
+            self.skipped_units.load(Ordering::Relaxed),
+            self.cancelled_operations.load(Ordering::Relaxed),
+        )
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_cancel_and_deadline() {
+        let state = CancelState::default();
+        assert!(state.check(3).is_ok());
+        state.record_completed();
+
+        state.set_timeout(Duration::ZERO);
+        let err = state.check(2).unwrap_err();
+        assert!(err.starts_with(CANCELLED));
+        assert!(err.contains("deadline"));
+
+        state.cancel();
+        assert_eq!(state.check(1).unwrap_err(), CANCELLED);
+        assert_eq!(state.stats(), (1, 3, 2));
+    }
+}
@@ -11,11 +11,20 @@
 //! 3. Optional rechunk for single contiguous slice per column
 //! 4. ReadAllAs<T> done entirely in C++ using column slices
 
+use crate::cancel::CancelState;
+use crate::key_index;
+use crate::row_group_plan::{self, RangeBounds, RangeOp};
 use crate::parquet::ParquetReader as PolarsReader;
 use polars::prelude::*;
 use polars_arrow::ffi::mmap::slice_and_owner;
+use rayon::prelude::*;
 use polars::io::parquet::write::BatchedWriter;
+use polars_parquet::parquet::metadata::FileMetadata;
+use polars_parquet::write::RowGroupIterColumns;
+use std::collections::{BTreeMap, HashMap};
 use std::io::BufWriter;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Arc, Mutex};
 
 #[cxx::bridge(namespace = "basis_rs::ffi")]
 mod ffi {
@@ -40,6 +49,24 @@ mod ffi {
         dtype: ColumnType,
     }
 
+    /// A string column as its distinct values plus one code per row
+    /// (index into `uniques`, in order of first appearance).
+    #[derive(Debug, Clone, Default)]
+    struct InternedColumn {
+        uniques: Vec<String>,
+        codes: Vec<u32>,
+    }
+
+    /// Work accounting of a cancellation token, summed over the operations
+    /// it was attached to. A batch is a streaming batch or a window of row
+    /// groups of a collect.
+    #[derive(Debug, Clone, Copy, Default)]
+    struct CancelStats {
+        completed_batches: u64,
+        skipped_batches: u64,
+        cancelled_operations: u64,
+    }
+
     /// Filter comparison operator shared between Rust and C++.
     #[derive(Debug, Clone, Copy, PartialEq, Eq)]
     enum FilterOp {
@@ -67,6 +94,10 @@ mod ffi {
         /// Opaque DataFrame wrapper - keeps data alive while C++ accesses it
         type ParquetDataFrame;
 
+        /// Number of worker threads in the Polars global pool (fixed at first
+        /// use; set POLARS_MAX_THREADS before the first call to change it).
+        fn parquet_thread_pool_size() -> usize;
+
         /// Open a parquet file and return a DataFrame wrapper
         fn parquet_open(path: &str) -> Result<Box<ParquetDataFrame>>;
 
@@ -90,9 +121,22 @@ mod ffi {
         /// Returns true if rechunking was performed (had multiple chunks).
         fn parquet_df_rechunk(df: &mut ParquetDataFrame) -> bool;
 
+        /// Rechunk a single column in place. Only that column is copied and
+        /// its old chunks are released once it is replaced.
+        /// Returns true if the column had multiple chunks.
+        fn parquet_df_rechunk_column(df: &mut ParquetDataFrame, column: &str) -> Result<bool>;
+
         /// Get number of chunks for a column (1 after rechunk)
         fn parquet_df_num_chunks(df: &ParquetDataFrame, column: &str) -> Result<usize>;
 
+        /// Data type of one column.
+        fn parquet_df_column_type(df: &ParquetDataFrame, column: &str) -> Result<ColumnType>;
+
+        /// Stored units per millisecond of a Datetime column (1, 1000 or
+        /// 1000000 for ms, us or ns).
+        fn parquet_df_datetime_units_per_ms(df: &ParquetDataFrame, column: &str)
+            -> Result<i64>;
+
         /// Get column chunks as raw pointers. Each chunk is contiguous memory.
         /// The pointers are valid as long as the ParquetDataFrame is alive.
         fn parquet_df_get_i64_chunks(
@@ -133,6 +177,51 @@ mod ffi {
         fn parquet_df_get_bool_column(df: &ParquetDataFrame, column: &str)
             -> Result<Vec<bool>>;
 
+        /// Get a string column dictionary-encoded: each distinct value once
+        /// plus a u32 code per row. Nulls read as "" (as in get_string_column).
+        fn parquet_df_intern_string_column(
+            df: &ParquetDataFrame,
+            column: &str,
+        ) -> Result<InternedColumn>;
+
+        /// Append the chunks of `other` to `df` (zero-copy vertical concat).
+        /// Column names and types must match in the same order.
+        fn parquet_df_vstack(df: &mut ParquetDataFrame, other: &ParquetDataFrame) -> Result<()>;
+
+        /// Stitch the columns of two DataFrames with equal row counts side by side.
+        /// Column buffers are shared with the inputs, not copied.
+        fn parquet_df_hstack(
+            left: &ParquetDataFrame,
+            right: &ParquetDataFrame,
+        ) -> Result<Box<ParquetDataFrame>>;
+
+        /// Project a subset of columns into a new DataFrame (zero-copy, shares buffers).
+        fn parquet_df_select(
+            df: &ParquetDataFrame,
+            columns: Vec<String>,
+        ) -> Result<Box<ParquetDataFrame>>;
+
+        /// Gather rows by index into a new DataFrame (rows are copied).
+        /// Fails if an index is out of bounds.
+        fn parquet_df_take(df: &ParquetDataFrame, indices: &[u32]) -> Result<Box<ParquetDataFrame>>;
+
+        // ==================== Shared DataFrame API ====================
+
+        /// Reference-counted handle to an immutable DataFrame (Arc on the Rust side).
+        /// Every function taking `&ParquetDataFrame` only reads, so a shared
+        /// DataFrame may be accessed from many threads concurrently.
+        type SharedParquetDataFrame;
+
+        /// Move an owned DataFrame behind a shared handle (no data is copied).
+        fn parquet_df_into_shared(df: Box<ParquetDataFrame>) -> Box<SharedParquetDataFrame>;
+
+        /// Create another handle to the same DataFrame (reference count increment).
+        fn parquet_shared_df_clone(shared: &SharedParquetDataFrame)
+            -> Box<SharedParquetDataFrame>;
+
+        /// Borrow the underlying DataFrame. Valid as long as the handle is alive.
+        fn parquet_shared_df_get(shared: &SharedParquetDataFrame) -> &ParquetDataFrame;
+
         // ==================== Writer API ====================
 
         type ParquetWriter;
@@ -178,9 +267,41 @@ mod ffi {
             name: &str,
             data: &[i64],
         ) -> Result<()>;
+        /// Data page size in bytes (0 = Polars default). Must be set before
+        /// the first batch is written.
+        fn parquet_writer_set_data_page_size(writer: &mut ParquetWriter, size: usize)
+            -> Result<()>;
+        /// Enable/disable min/max/null-count statistics (default: enabled).
+        /// Must be set before the first batch is written.
+        fn parquet_writer_set_statistics(writer: &mut ParquetWriter, enabled: bool)
+            -> Result<()>;
         fn parquet_writer_write_batch(writer: &mut ParquetWriter) -> Result<()>;
+        /// Drop the columns added since the last batch (after a failed add).
+        fn parquet_writer_clear_columns(writer: &mut ParquetWriter);
         fn parquet_writer_finish(writer: Box<ParquetWriter>) -> Result<()>;
 
+        // Concurrent writer: producers stage and encode their own row groups,
+        // the sequencer appends them to one file in the order they were sealed
+        type ParquetSharedWriter;
+
+        fn parquet_shared_writer_new(
+            path: &str,
+            compression: &str,
+            data_page_size: usize,
+            statistics: bool,
+        ) -> Result<Box<ParquetSharedWriter>>;
+        /// Column stage for one producer (a ParquetWriter that is never opened).
+        fn parquet_shared_writer_stage(shared: &ParquetSharedWriter) -> Box<ParquetWriter>;
+        /// Encode and compress the stage's columns as one row group on the
+        /// calling thread, then hand it to the sequencer. Thread-safe.
+        fn parquet_shared_writer_encode(
+            shared: &ParquetSharedWriter,
+            stage: &mut ParquetWriter,
+        ) -> Result<()>;
+        /// Row groups appended to the file so far.
+        fn parquet_shared_writer_num_row_groups(shared: &ParquetSharedWriter) -> u64;
+        fn parquet_shared_writer_finish(shared: Box<ParquetSharedWriter>) -> Result<()>;
+
         // Zero-copy column add — data must remain valid until write_batch()
         fn parquet_writer_add_i64_column_zerocopy(
             writer: &mut ParquetWriter,
@@ -210,6 +331,8 @@ mod ffi {
 
         // Query builder functions (lazy evaluation with predicate/projection pushdown)
         fn parquet_query_new(path: &str) -> Result<Box<ParquetQuery>>;
+        /// Query over an already-loaded DataFrame (no disk access on collect)
+        fn parquet_query_from_df(df: &ParquetDataFrame) -> Box<ParquetQuery>;
         fn parquet_query_select(query: &mut ParquetQuery, columns: Vec<String>);
         fn parquet_query_filter_i64(
             query: &mut ParquetQuery,
@@ -247,9 +370,108 @@ mod ffi {
             op: FilterOp,
             value: bool,
         );
+        /// Compare a Datetime column against a UTC epoch-milliseconds instant.
+        /// The literal is converted to the column's time unit and time zone.
+        fn parquet_query_filter_datetime(
+            query: &mut ParquetQuery,
+            column: &str,
+            op: FilterOp,
+            epoch_ms: i64,
+        );
+        /// Keep rows whose integer column value is one of `values`
+        fn parquet_query_filter_in_i64(query: &mut ParquetQuery, column: &str, values: &[i64]);
+
+        /// Build the `<path>.<column>.keyidx` sidecar used to narrow Eq/IsIn
+        /// filters on an integer key column to the row spans holding the keys.
+        fn parquet_build_key_index(path: &str, column: &str) -> Result<()>;
+
+        // ==================== Cancellation API ====================
+
+        /// Shared cancellation flag and deadline; checked between batches.
+        type ParquetCancelToken;
+
+        fn parquet_cancel_token_new() -> Box<ParquetCancelToken>;
+        fn parquet_cancel_token_cancel(token: &ParquetCancelToken);
+        /// Cancel once `timeout_us` microseconds have elapsed from now.
+        fn parquet_cancel_token_set_timeout(token: &ParquetCancelToken, timeout_us: u64);
+        fn parquet_cancel_token_is_cancelled(token: &ParquetCancelToken) -> bool;
+        fn parquet_cancel_token_stats(token: &ParquetCancelToken) -> CancelStats;
+        /// Attach a token. Cancelled queries fail with an error starting with
+        /// "Operation cancelled".
+        fn parquet_query_set_cancel_token(query: &mut ParquetQuery, token: &ParquetCancelToken);
 
         /// Collect query into zero-copy DataFrame
         fn parquet_query_collect_df(query: Box<ParquetQuery>) -> Result<Box<ParquetDataFrame>>;
+
+        // ==================== Streaming API ====================
+
+        /// Row-group-at-a-time execution of a query.
+        type ParquetBatchReader;
+
+        /// Plan a query for streaming. File sources yield one batch per row
+        /// group the key index or sorted planning does not rule out;
+        /// in-memory sources yield a single batch.
+        fn parquet_query_batches(query: Box<ParquetQuery>) -> Result<Box<ParquetBatchReader>>;
+        fn parquet_batch_reader_num_batches(reader: &ParquetBatchReader) -> usize;
+        /// Execute the query over one batch (projection and filters applied).
+        fn parquet_batch_reader_read(
+            reader: &ParquetBatchReader,
+            index: usize,
+        ) -> Result<Box<ParquetDataFrame>>;
+
+        // ==================== Batch Query API ====================
+
+        /// Rows of several files split by key, one DataFrame per key.
+        type ParquetBatchQueryResult;
+
+        /// Read each file once with `key_column IN keys` (files in parallel),
+        /// then split the rows by key. Empty `columns` reads all columns.
+        fn parquet_batch_query(
+            paths: Vec<String>,
+            key_column: &str,
+            keys: &[i64],
+            columns: Vec<String>,
+        ) -> Result<Box<ParquetBatchQueryResult>>;
+        /// Number of distinct requested keys (including keys with no rows).
+        fn parquet_batch_query_num_keys(result: &ParquetBatchQueryResult) -> usize;
+        /// Key at `index`, in ascending key order.
+        fn parquet_batch_query_key(result: &ParquetBatchQueryResult, index: usize) -> i64;
+        /// Rows of the key at `index`, in file order (cheap: shares buffers).
+        fn parquet_batch_query_frame(
+            result: &ParquetBatchQueryResult,
+            index: usize,
+        ) -> Box<ParquetDataFrame>;
+
+        // ==================== Async Task API ====================
+
+        /// One operation running on the Polars pool. When it finishes, the
+        /// result is stored in the task and `parquet_task_complete(ctx)` is
+        /// called on the pool thread that ran it.
+        type ParquetTask;
+
+        fn parquet_task_new() -> Box<ParquetTask>;
+        /// Open a Parquet file (all columns) in the background.
+        fn parquet_task_open(task: &ParquetTask, path: &str, ctx: usize);
+        /// Collect a query in the background.
+        fn parquet_task_collect(task: &ParquetTask, query: Box<ParquetQuery>, ctx: usize);
+        /// Write the writer's pending columns as a batch in the background.
+        /// The writer's state moves into the task, leaving an unopened writer
+        /// in its place until parquet_task_restore_writer() puts it back.
+        fn parquet_task_write_batch(task: &ParquetTask, writer: &mut ParquetWriter, ctx: usize);
+        /// DataFrame produced by an open/collect task, or its error.
+        fn parquet_task_take_frame(task: &ParquetTask) -> Result<Box<ParquetDataFrame>>;
+        /// Move the state of a write task's writer back into `writer`
+        /// (restored even if the write failed).
+        fn parquet_task_restore_writer(task: &ParquetTask, writer: &mut ParquetWriter) -> Result<()>;
+        /// Error of a completed task, if any.
+        fn parquet_task_check(task: &ParquetTask) -> Result<()>;
+    }
+
+    unsafe extern "C++" {
+        include!("basis_rs/parquet/detail/task_callback.hpp");
+
+        /// Completion hook for ParquetTask, implemented by the C++ awaitables.
+        fn parquet_task_complete(ctx: usize);
     }
 }
 
@@ -261,6 +483,12 @@ pub struct ParquetDataFrame {
     df: DataFrame,
 }
 
+/// Shared, immutable DataFrame. `ParquetDataFrame` is `Send + Sync`, so the
+/// Arc may be cloned into any number of C++ threads.
+pub struct SharedParquetDataFrame {
+    inner: Arc<ParquetDataFrame>,
+}
+
 fn dtype_to_column_type(dtype: &DataType) -> ffi::ColumnType {
     match dtype {
         DataType::Int64 => ffi::ColumnType::Int64,
@@ -275,6 +503,10 @@ fn dtype_to_column_type(dtype: &DataType) -> ffi::ColumnType {
     }
 }
 
+fn parquet_thread_pool_size() -> usize {
+    polars_core::POOL.current_num_threads()
+}
+
 fn parquet_open(path: &str) -> Result<Box<ParquetDataFrame>, String> {
     let df = PolarsReader::new(path).read().map_err(|e| e.to_string())?;
     Ok(Box::new(ParquetDataFrame { df }))
@@ -320,11 +552,42 @@ fn parquet_df_rechunk(df: &mut ParquetDataFrame) -> bool {
     had_multiple
 }
 
+fn parquet_df_rechunk_column(df: &mut ParquetDataFrame, column: &str) -> Result<bool, String> {
+    let col = df.df.column(column).map_err(|e| e.to_string())?;
+    if col.n_chunks() <= 1 {
+        return Ok(false);
+    }
+    let rechunked = col.rechunk();
+    df.df.with_column(rechunked).map_err(|e| e.to_string())?;
+    Ok(true)
+}
+
 fn parquet_df_num_chunks(df: &ParquetDataFrame, column: &str) -> Result<usize, String> {
     let col = df.df.column(column).map_err(|e| e.to_string())?;
     Ok(col.n_chunks())
 }
 
+fn parquet_df_column_type(df: &ParquetDataFrame, column: &str) -> Result<ffi::ColumnType, String> {
+    let col = df
+        .df
+        .column(column)
+        .map_err(|e| format!("Column '{}' not found: {}", column, e))?;
+    Ok(dtype_to_column_type(col.dtype()))
+}
+
+fn parquet_df_datetime_units_per_ms(df: &ParquetDataFrame, column: &str) -> Result<i64, String> {
+    let col = df
+        .df
+        .column(column)
+        .map_err(|e| format!("Column '{}' not found: {}", column, e))?;
+    match col.dtype() {
+        DataType::Datetime(TimeUnit::Milliseconds, _) => Ok(1),
+        DataType::Datetime(TimeUnit::Microseconds, _) => Ok(1_000),
+        DataType::Datetime(TimeUnit::Nanoseconds, _) => Ok(1_000_000),
+        dtype => Err(format!("Column '{}' is not Datetime: {}", column, dtype)),
+    }
+}
+
 // Macro to generate chunk getter functions for primitive types
 macro_rules! impl_get_chunks {
     ($fn_name:ident, $polars_method:ident, $rust_type:ty) => {
@@ -436,6 +699,35 @@ fn parquet_df_get_string_column(
     Ok(ca.iter().map(|opt| opt.unwrap_or("").to_string()).collect())
 }
 
+fn parquet_df_intern_string_column(
+    df: &ParquetDataFrame,
+    column: &str,
+) -> Result<ffi::InternedColumn, String> {
+    let col = df
+        .df
+        .column(column)
+        .map_err(|e| format!("Column '{}' not found: {}", column, e))?;
+
+    let ca = col
+        .str()
+        .map_err(|e| format!("Column '{}' is not String: {}", column, e))?;
+
+    // Rows are hashed as borrowed &str; only distinct values are copied out
+    let mut index: HashMap<&str, u32> = HashMap::new();
+    let mut uniques = Vec::new();
+    let mut codes = Vec::with_capacity(ca.len());
+    for value in ca.iter() {
+        let value = value.unwrap_or("");
+        let next = uniques.len() as u32;
+        let code = *index.entry(value).or_insert_with(|| {
+            uniques.push(value.to_string());
+            next
+        });
+        codes.push(code);
+    }
+    Ok(ffi::InternedColumn { uniques, codes })
+}
+
 fn parquet_df_get_bool_column(
     df: &ParquetDataFrame,
     column: &str,
@@ -453,6 +745,84 @@ fn parquet_df_get_bool_column(
     Ok(ca.iter().map(|opt| opt.unwrap_or(false)).collect())
 }
 
+fn parquet_df_vstack(df: &mut ParquetDataFrame, other: &ParquetDataFrame) -> Result<(), String> {
+    if df.df.width() != other.df.width() {
+        return Err(format!(
+            "Cannot concat: column count mismatch ({} vs {})",
+            df.df.width(),
+            other.df.width()
+        ));
+    }
+    for (a, b) in df.df.get_columns().iter().zip(other.df.get_columns()) {
+        if a.name() != b.name() || a.dtype() != b.dtype() {
+            return Err(format!(
+                "Cannot concat: column '{}' ({}) does not match '{}' ({})",
+                a.name(),
+                a.dtype(),
+                b.name(),
+                b.dtype()
+            ));
+        }
+    }
+
+    // vstack_mut appends the other frame's Arrow arrays as extra chunks;
+    // the buffers are reference-counted, so no column data is copied.
+    df.df.vstack_mut(&other.df).map_err(|e| e.to_string())?;
+    Ok(())
+}
+
+fn parquet_df_hstack(
+    left: &ParquetDataFrame,
+    right: &ParquetDataFrame,
+) -> Result<Box<ParquetDataFrame>, String> {
+    if left.df.height() != right.df.height() {
+        return Err(format!(
+            "Cannot hstack: row count mismatch ({} vs {})",
+            left.df.height(),
+            right.df.height()
+        ));
+    }
+
+    // Cloning a Column only bumps the reference count of its chunks.
+    let df = left
+        .df
+        .hstack(right.df.get_columns())
+        .map_err(|e| e.to_string())?;
+    Ok(Box::new(ParquetDataFrame { df }))
+}
+
+fn parquet_df_select(
+    df: &ParquetDataFrame,
+    columns: Vec<String>,
+) -> Result<Box<ParquetDataFrame>, String> {
+    let df = df.df.select(columns).map_err(|e| e.to_string())?;
+    Ok(Box::new(ParquetDataFrame { df }))
+}
+
+fn parquet_df_take(df: &ParquetDataFrame, indices: &[u32]) -> Result<Box<ParquetDataFrame>, String> {
+    let idx = IdxCa::from_vec(PlSmallStr::EMPTY, indices.iter().map(|&i| i as IdxSize).collect());
+    let df = df.df.take(&idx).map_err(|e| e.to_string())?;
+    Ok(Box::new(ParquetDataFrame { df }))
+}
+
+// ==================== Shared DataFrame Implementation ====================
+
+fn parquet_df_into_shared(df: Box<ParquetDataFrame>) -> Box<SharedParquetDataFrame> {
+    Box::new(SharedParquetDataFrame {
+        inner: Arc::from(df),
+    })
+}
+
+fn parquet_shared_df_clone(shared: &SharedParquetDataFrame) -> Box<SharedParquetDataFrame> {
+    Box::new(SharedParquetDataFrame {
+        inner: Arc::clone(&shared.inner),
+    })
+}
+
+fn parquet_shared_df_get(shared: &SharedParquetDataFrame) -> &ParquetDataFrame {
+    &shared.inner
+}
+
 // ==================== Writer Implementation ====================
 
 /// Wrapper for building and writing a Parquet file with streaming support.
@@ -461,9 +831,27 @@ pub struct ParquetWriter {
     columns: Vec<Column>,
     compression: ParquetCompression,
     row_group_size: usize, // 0 = default
+    data_page_size: usize, // 0 = default
+    statistics: bool,
     batched: Option<BatchedWriter<BufWriter<std::fs::File>>>,
 }
 
+impl ParquetWriter {
+    /// Move the state out, leaving an unopened writer with the same settings.
+    fn detach(&mut self) -> ParquetWriter {
+        let placeholder = ParquetWriter {
+            path: self.path.clone(),
+            columns: Vec::new(),
+            compression: self.compression,
+            row_group_size: self.row_group_size,
+            data_page_size: self.data_page_size,
+            statistics: self.statistics,
+            batched: None,
+        };
+        std::mem::replace(self, placeholder)
+    }
+}
+
 fn parse_compression(s: &str) -> Result<ParquetCompression, String> {
     match s {
         "zstd" | "" => Ok(ParquetCompression::Zstd(None)),
@@ -485,10 +873,28 @@ fn parquet_writer_new(
         columns: Vec::new(),
         compression: parse_compression(compression)?,
         row_group_size,
+        data_page_size: 0,
+        statistics: true,
         batched: None,
     }))
 }
 
+fn parquet_writer_set_data_page_size(writer: &mut ParquetWriter, size: usize) -> Result<(), String> {
+    if writer.batched.is_some() {
+        return Err("Data page size must be set before the first batch".to_string());
+    }
+    writer.data_page_size = size;
+    Ok(())
+}
+
+fn parquet_writer_set_statistics(writer: &mut ParquetWriter, enabled: bool) -> Result<(), String> {
+    if writer.batched.is_some() {
+        return Err("Statistics must be configured before the first batch".to_string());
+    }
+    writer.statistics = enabled;
+    Ok(())
+}
+
 fn parquet_writer_add_column(writer: &mut ParquetWriter, series: Series) {
     writer.columns.push(series.into());
 }
@@ -621,6 +1027,10 @@ fn parquet_writer_add_datetime_column_zerocopy(
     Ok(())
 }
 
+fn parquet_writer_clear_columns(writer: &mut ParquetWriter) {
+    writer.columns.clear();
+}
+
 fn parquet_writer_write_batch(writer: &mut ParquetWriter) -> Result<(), String> {
     if writer.columns.is_empty() {
         return Ok(());
@@ -630,15 +1040,7 @@ fn parquet_writer_write_batch(writer: &mut ParquetWriter) -> Result<(), String>
     let df = DataFrame::new(columns).map_err(|e| e.to_string())?;
 
     if writer.batched.is_none() {
-        let file = std::fs::File::create(&writer.path).map_err(|e| e.to_string())?;
-        let buf = BufWriter::new(file);
-        let mut pw = polars::io::parquet::write::ParquetWriter::new(buf)
-            .with_compression(writer.compression);
-        if writer.row_group_size > 0 {
-            pw = pw.with_row_group_size(Some(writer.row_group_size));
-        }
-        // row_group_size=0 means Polars default (~262K rows per row group)
-        writer.batched = Some(pw.batched(df.schema()).map_err(|e| e.to_string())?);
+        writer.batched = Some(open_batched(writer, df.schema())?);
     }
 
     writer
@@ -650,6 +1052,31 @@ fn parquet_writer_write_batch(writer: &mut ParquetWriter) -> Result<(), String>
     Ok(())
 }
 
+/// Create the output file and a batched writer for `schema` with the
+/// writer's options.
+fn open_batched(
+    writer: &ParquetWriter,
+    schema: &Schema,
+) -> Result<BatchedWriter<BufWriter<std::fs::File>>, String> {
+    let file = std::fs::File::create(&writer.path).map_err(|e| e.to_string())?;
+    let buf = BufWriter::new(file);
+    let mut pw =
+        polars::io::parquet::write::ParquetWriter::new(buf).with_compression(writer.compression);
+    if writer.row_group_size > 0 {
+        pw = pw.with_row_group_size(Some(writer.row_group_size));
+    }
+    if writer.data_page_size > 0 {
+        pw = pw.with_data_page_size(Some(writer.data_page_size));
+    }
+    pw = pw.with_statistics(if writer.statistics {
+        StatisticsOptions::default()
+    } else {
+        StatisticsOptions::empty()
+    });
+    // row_group_size=0 means Polars default (~262K rows per row group)
+    pw.batched(schema).map_err(|e| e.to_string())
+}
+
 fn parquet_writer_finish(mut writer: Box<ParquetWriter>) -> Result<(), String> {
     // Flush remaining columns
     if !writer.columns.is_empty() {
@@ -662,13 +1089,211 @@ fn parquet_writer_finish(mut writer: Box<ParquetWriter>) -> Result<(), String> {
     Ok(())
 }
 
+// ==================== Concurrent Writer Implementation ====================
+
+/// One output file fed by many producer threads.
+///
+/// Each producer fills its own column stage and calls
+/// `parquet_shared_writer_encode`, which encodes and compresses the stage as
+/// one row group on the producer's thread, without holding any lock. Every
+/// sealed row group gets a ticket; the sequencer appends finished row groups
+/// strictly in ticket order, so the only serialized work is the file append.
+pub struct ParquetSharedWriter {
+    /// Options and path (never holds columns or a batched writer)
+    config: ParquetWriter,
+    /// Created from the first row group's schema
+    batched: Mutex<Option<(Arc<BatchedWriter<BufWriter<std::fs::File>>>, SchemaRef)>>,
+    next_ticket: AtomicU64,
+    sequencer: Mutex<Sequencer>,
+}
+
+#[derive(Default)]
+struct Sequencer {
+    /// Next ticket to append
+    next: u64,
+    /// Encoded row groups waiting for an earlier ticket (`None`: failed)
+    ready: BTreeMap<u64, Option<Vec<RowGroupIterColumns<'static, PolarsError>>>>,
+    appended: u64,
+    /// First encode or append error; the file is unusable afterwards and
+    /// finish() reports it
+    error: Option<String>,
+}
+
+fn parquet_shared_writer_new(
+    path: &str,
+    compression: &str,
+    data_page_size: usize,
+    statistics: bool,
+) -> Result<Box<ParquetSharedWriter>, String> {
+    let mut config = parquet_writer_new(path, compression, 0)?;
+    config.data_page_size = data_page_size;
+    config.statistics = statistics;
+    Ok(Box::new(ParquetSharedWriter {
+        config: *config,
+        batched: Mutex::new(None),
+        next_ticket: AtomicU64::new(0),
+        sequencer: Mutex::new(Sequencer::default()),
+    }))
+}
+
+fn parquet_shared_writer_stage(shared: &ParquetSharedWriter) -> Box<ParquetWriter> {
+    Box::new(ParquetWriter {
+        path: String::new(),
+        columns: Vec::new(),
+        compression: shared.config.compression,
+        row_group_size: 0,
+        data_page_size: shared.config.data_page_size,
+        statistics: shared.config.statistics,
+        batched: None,
+    })
+}
+
+fn parquet_shared_writer_encode(
+    shared: &ParquetSharedWriter,
+    stage: &mut ParquetWriter,
+) -> Result<(), String> {
+    if stage.columns.is_empty() {
+        return Ok(());
+    }
+    let columns = std::mem::take(&mut stage.columns);
+    let ticket = shared.next_ticket.fetch_add(1, Ordering::Relaxed);
+
+    let encoded = encode_row_group(shared, columns);
+
+    let mut guard = shared.sequencer.lock().unwrap();
+    let seq = &mut *guard;
+    let (row_groups, result) = match encoded {
+        Ok(row_groups) => (Some(row_groups), Ok(())),
+        // The ticket is still retired so later row groups are not held back,
+        // but the error sticks: a file missing a row group must not finish
+        Err(e) => {
+            seq.error.get_or_insert_with(|| e.clone());
+            (None, Err(e))
+        }
+    };
+    seq.ready.insert(ticket, row_groups);
+    while let Some(entry) = seq.ready.remove(&seq.next) {
+        seq.next += 1;
+        let Some(row_groups) = entry else { continue };
+        if seq.error.is_some() {
+            continue;
+        }
+        let batched = shared.batched.lock().unwrap().as_ref().unwrap().0.clone();
+        let count = row_groups.len() as u64;
+        match batched.write_row_groups(row_groups) {
+            Ok(()) => seq.appended += count,
+            Err(e) => seq.error = Some(e.to_string()),
+        }
+    }
+    // Report this producer's own encode error ahead of an earlier one
+    result?;
+    match &seq.error {
+        Some(e) => Err(e.clone()),
+        None => Ok(()),
+    }
+}
+
+/// Build a single-chunk DataFrame from `columns` and encode it as one row
+/// group. Runs on the producer's thread.
+fn encode_row_group(
+    shared: &ParquetSharedWriter,
+    columns: Vec<Column>,
+) -> Result<Vec<RowGroupIterColumns<'static, PolarsError>>, String> {
+    let mut df = DataFrame::new(columns).map_err(|e| e.to_string())?;
+    df.as_single_chunk_par();
+
+    let batched = {
+        let mut guard = shared.batched.lock().unwrap();
+        match guard.as_ref() {
+            Some((batched, schema)) => {
+                if **schema != **df.schema() {
+                    return Err("Row group schema differs from the file schema".to_string());
+                }
+                batched.clone()
+            }
+            None => {
+                let batched = Arc::new(open_batched(&shared.config, df.schema())?);
+                *guard = Some((batched.clone(), df.schema().clone()));
+                batched
+            }
+        }
+    };
+    batched
+        .encode_and_compress(&df)
+        .collect::<PolarsResult<Vec<_>>>()
+        .map_err(|e| e.to_string())
+}
+
+fn parquet_shared_writer_num_row_groups(shared: &ParquetSharedWriter) -> u64 {
+    shared.sequencer.lock().unwrap().appended
+}
+
+fn parquet_shared_writer_finish(shared: Box<ParquetSharedWriter>) -> Result<(), String> {
+    let seq = shared.sequencer.lock().unwrap();
+    if let Some(e) = &seq.error {
+        return Err(e.clone());
+    }
+    if seq.next != shared.next_ticket.load(Ordering::Relaxed) {
+        return Err("Row groups are still being encoded".to_string());
+    }
+    if let Some((batched, _)) = shared.batched.lock().unwrap().as_ref() {
+        batched.finish().map_err(|e| e.to_string())?;
+    }
+    Ok(())
+}
+
 // ==================== Query Builder Implementation ====================
 
+/// Where a query reads its rows from.
+enum QuerySource {
+    /// Lazy scan of a Parquet file (projection/predicate pushdown).
+    Path(String),
+    /// In-memory DataFrame (cheap clone: columns are reference-counted).
+    Frame(DataFrame),
+}
+
 /// Lazy query builder. Accumulates select/filter, executes on collect().
 pub struct ParquetQuery {
-    path: String,
+    source: QuerySource,
     columns: Vec<String>,
-    filters: Vec<Expr>,
+    /// Other filters, each with the column it reads.
+    filters: Vec<(String, Expr)>,
+    /// Comparisons on integer columns, which the sorted-file planner can
+    /// resolve from row-group statistics.
+    int_filters: Vec<IntFilter>,
+    /// Eq/IsIn filters on integer columns, which a key index can serve.
+    key_filters: Vec<(String, Vec<i64>)>,
+    /// Datetime comparisons (epoch ms), typed against the schema at execution.
+    datetime_filters: Vec<(String, ffi::FilterOp, i64)>,
+    /// Checked between row groups when set.
+    cancel: Option<Arc<CancelState>>,
+}
+
+/// Integer comparison kept in structured form next to its expression.
+/// Datetime filters resolve to one in the column's unit.
+#[derive(Clone)]
+struct IntFilter {
+    column: String,
+    op: ffi::FilterOp,
+    value: i64,
+    expr: Expr,
+}
+
+/// The range comparison `op` describes, if any (Ne is not a range).
+fn range_op(op: ffi::FilterOp) -> Option<RangeOp> {
+    if op == ffi::FilterOp::Eq {
+        Some(RangeOp::Eq)
+    } else if op == ffi::FilterOp::Lt {
+        Some(RangeOp::Lt)
+    } else if op == ffi::FilterOp::Le {
+        Some(RangeOp::Le)
+    } else if op == ffi::FilterOp::Gt {
+        Some(RangeOp::Gt)
+    } else if op == ffi::FilterOp::Ge {
+        Some(RangeOp::Ge)
+    } else {
+        None
+    }
 }
 
 fn make_filter_expr(column: &str, op: ffi::FilterOp, value: Expr) -> Expr {
@@ -695,30 +1320,66 @@ fn parquet_query_new(path: &str) -> Result<Box<ParquetQuery>, String> {
         return Err(format!("File not found: {}", path));
     }
     Ok(Box::new(ParquetQuery {
-        path: path.to_string(),
+        source: QuerySource::Path(path.to_string()),
         columns: Vec::new(),
         filters: Vec::new(),
+        int_filters: Vec::new(),
+        key_filters: Vec::new(),
+        datetime_filters: Vec::new(),
+        cancel: None,
     }))
 }
 
+fn parquet_query_from_df(df: &ParquetDataFrame) -> Box<ParquetQuery> {
+    Box::new(ParquetQuery {
+        source: QuerySource::Frame(df.df.clone()),
+        columns: Vec::new(),
+        filters: Vec::new(),
+        int_filters: Vec::new(),
+        key_filters: Vec::new(),
+        datetime_filters: Vec::new(),
+        cancel: None,
+    })
+}
+
 fn parquet_query_select(query: &mut ParquetQuery, columns: Vec<String>) {
     query.columns = columns;
 }
 
 fn parquet_query_filter_i64(query: &mut ParquetQuery, column: &str, op: ffi::FilterOp, value: i64) {
-    query.filters.push(make_filter_expr(column, op, lit(value)));
+    if op == ffi::FilterOp::Eq {
+        query.key_filters.push((column.to_string(), vec![value]));
+    }
+    query.int_filters.push(IntFilter {
+        column: column.to_string(),
+        op,
+        value,
+        expr: make_filter_expr(column, op, lit(value)),
+    });
 }
 
 fn parquet_query_filter_i32(query: &mut ParquetQuery, column: &str, op: ffi::FilterOp, value: i32) {
-    query.filters.push(make_filter_expr(column, op, lit(value)));
+    if op == ffi::FilterOp::Eq {
+        query.key_filters.push((column.to_string(), vec![value as i64]));
+    }
+    query.int_filters.push(IntFilter {
+        column: column.to_string(),
+        op,
+        value: value as i64,
+        expr: make_filter_expr(column, op, lit(value)),
+    });
 }
 
 fn parquet_query_filter_f64(query: &mut ParquetQuery, column: &str, op: ffi::FilterOp, value: f64) {
-    query.filters.push(make_filter_expr(column, op, lit(value)));
+    query
+        .filters
+        .push((column.to_string(), make_filter_expr(column, op, lit(value))));
 }
 
 fn parquet_query_filter_f32(query: &mut ParquetQuery, column: &str, op: ffi::FilterOp, value: f32) {
-    query.filters.push(make_filter_expr(column, op, lit(value)));
+    query
+        .filters
+        .push((column.to_string(), make_filter_expr(column, op, lit(value))));
 }
 
 fn parquet_query_filter_str(
@@ -727,9 +1388,10 @@ fn parquet_query_filter_str(
     op: ffi::FilterOp,
     value: &str,
 ) {
-    query
-        .filters
-        .push(make_filter_expr(column, op, lit(value.to_string())));
+    query.filters.push((
+        column.to_string(),
+        make_filter_expr(column, op, lit(value.to_string())),
+    ));
 }
 
 fn parquet_query_filter_bool(
@@ -738,28 +1400,719 @@ fn parquet_query_filter_bool(
     op: ffi::FilterOp,
     value: bool,
 ) {
-    query.filters.push(make_filter_expr(column, op, lit(value)));
+    query
+        .filters
+        .push((column.to_string(), make_filter_expr(column, op, lit(value))));
 }
 
-fn execute_query(query: &ParquetQuery) -> Result<DataFrame, String> {
-    let args = ScanArgsParquet::default();
-    let mut lf = LazyFrame::scan_parquet(&query.path, args).map_err(|e| e.to_string())?;
+fn parquet_query_filter_datetime(
+    query: &mut ParquetQuery,
+    column: &str,
+    op: ffi::FilterOp,
+    epoch_ms: i64,
+) {
+    query
+        .datetime_filters
+        .push((column.to_string(), op, epoch_ms));
+}
+
+/// Integer filter for a datetime comparison, in the column's unit. The
+/// literal takes the column's exact dtype (unit and time zone), so no cast
+/// lands on the column side and the predicate stays eligible for statistics
+/// pushdown.
+fn datetime_filter(
+    schema: &Schema,
+    column: &str,
+    op: ffi::FilterOp,
+    epoch_ms: i64,
+) -> Result<IntFilter, String> {
+    let dtype = schema
+        .get(column)
+        .ok_or_else(|| format!("Column not found: {}", column))?;
+    let value = match dtype {
+        DataType::Datetime(TimeUnit::Milliseconds, _) => epoch_ms,
+        DataType::Datetime(TimeUnit::Microseconds, _) => epoch_ms * 1_000,
+        DataType::Datetime(TimeUnit::Nanoseconds, _) => epoch_ms * 1_000_000,
+        other => {
+            return Err(format!(
+                "Column '{}' is not a Datetime column ({})",
+                column, other
+            ))
+        }
+    };
+    Ok(IntFilter {
+        column: column.to_string(),
+        op,
+        value,
+        expr: make_filter_expr(column, op, lit(value).cast(dtype.clone())),
+    })
+}
 
-    // Apply projection
-    if !query.columns.is_empty() {
-        let col_exprs: Vec<_> = query.columns.iter().map(|c| col(c.as_str())).collect();
-        lf = lf.select(col_exprs);
+fn parquet_query_filter_in_i64(query: &mut ParquetQuery, column: &str, values: &[i64]) {
+    query
+        .key_filters
+        .push((column.to_string(), values.to_vec()));
+    // Compare as Int64 so the same call serves Int32 key columns
+    let keys = Series::new(column.into(), values.to_vec());
+    query.filters.push((
+        column.to_string(),
+        col(column).cast(DataType::Int64).is_in(lit(keys)),
+    ));
+
+    // The key range, so sorted row-group planning can skip groups outside
+    // [min, max]; the IN filter above still applies to the groups read
+    if let (Some(&min), Some(&max)) = (values.iter().min(), values.iter().max()) {
+        for (op, value) in [(ffi::FilterOp::Ge, min), (ffi::FilterOp::Le, max)] {
+            query.int_filters.push(IntFilter {
+                column: column.to_string(),
+                op,
+                value,
+                expr: make_filter_expr(column, op, lit(value)),
+            });
+        }
     }
+}
+
+fn parquet_build_key_index(path: &str, column: &str) -> Result<(), String> {
+    key_index::build_key_index(path, column)
+}
+
+/// Row spans a query has to read according to a valid key index, if any of
+/// its key filters has one. The remaining filters still apply to the spans.
+fn indexed_spans(path: &str, query: &ParquetQuery) -> Option<Vec<(usize, usize)>> {
+    query.key_filters.iter().find_map(|(column, keys)| {
+        // An unreadable sidecar falls back to a full scan
+        key_index::lookup(path, column, keys).ok().flatten()
+    })
+}
+
+/// Concatenate partial scans in order, without rechunking.
+fn concat_parts(parts: Vec<LazyFrame>) -> Result<LazyFrame, String> {
+    concat(
+        parts,
+        UnionArgs {
+            parallel: true,
+            rechunk: false,
+            ..Default::default()
+        },
+    )
+    .map_err(|e| e.to_string())
+}
 
-    // Apply filters (AND-ed together)
-    for filter_expr in &query.filters {
+/// Apply the query's filters (AND-ed together). Range comparisons on
+/// `covered` are skipped: the caller has proven them true for every row.
+fn apply_filters(
+    mut lf: LazyFrame,
+    query: &ParquetQuery,
+    int_filters: &[IntFilter],
+    covered: Option<&str>,
+) -> LazyFrame {
+    for (_, filter_expr) in &query.filters {
         lf = lf.filter(filter_expr.clone());
     }
+    for filter in int_filters {
+        let skip = covered == Some(filter.column.as_str()) && range_op(filter.op).is_some();
+        if !skip {
+            lf = lf.filter(filter.expr.clone());
+        }
+    }
+    lf
+}
+
+/// A row span (offset, len, covered) of a file to read. `covered` names a
+/// column whose range filters hold for every row of the span, so they are
+/// not evaluated there.
+type ScanSpan<'a> = (usize, usize, Option<&'a str>);
+
+/// Row spans from sorted row-group statistics. Picks the first
+/// range-filtered column whose statistics are monotonic; returns `None` if
+/// there is none.
+///
+/// Covered row groups are read without the range predicate on that column;
+/// boundary groups keep it. Row groups outside the range are never read.
+fn sorted_spans<'a>(metadata: &FileMetadata, int_filters: &'a [IntFilter]) -> Option<Vec<ScanSpan<'a>>> {
+    let mut columns: Vec<&str> = Vec::new();
+    for filter in int_filters {
+        if range_op(filter.op).is_some() && !columns.contains(&filter.column.as_str()) {
+            columns.push(&filter.column);
+        }
+    }
+
+    for column in columns {
+        let Some(groups) = row_group_plan::sorted_int_stats_of(metadata, column) else {
+            continue;
+        };
+        let mut bounds = RangeBounds::default();
+        for filter in int_filters.iter().filter(|f| f.column == column) {
+            if let Some(op) = range_op(filter.op) {
+                bounds.add(op, filter.value);
+            }
+        }
+        let spans = row_group_plan::plan(&groups, &bounds)
+            .into_iter()
+            .map(|(offset, len, covered)| (offset, len, covered.then_some(column)))
+            .collect();
+        return Some(spans);
+    }
+    None
+}
+
+/// True if some filter is a range comparison that a key index or sorted
+/// row-group statistics could narrow the scan for.
+fn has_range_filter(int_filters: &[IntFilter]) -> bool {
+    int_filters.iter().any(|f| range_op(f.op).is_some())
+}
 
-    lf.collect().map_err(|e| e.to_string())
+/// Row spans a full-file query has to read: those of a valid key index if
+/// one serves the query, otherwise those planned from sorted row-group
+/// statistics in `metadata`. `None` if neither applies and every row must
+/// be read.
+fn plan_spans<'a>(
+    path: &str,
+    metadata: &FileMetadata,
+    query: &ParquetQuery,
+    int_filters: &'a [IntFilter],
+) -> Option<Vec<ScanSpan<'a>>> {
+    if let Some(spans) = indexed_spans(path, query) {
+        return Some(spans.into_iter().map(|(offset, len)| (offset, len, None)).collect());
+    }
+    sorted_spans(metadata, int_filters)
+}
+
+/// Read `spans` of `scan`, concatenated in order, with the query's filters.
+fn read_spans(
+    scan: &LazyFrame,
+    query: &ParquetQuery,
+    int_filters: &[IntFilter],
+    spans: &[ScanSpan],
+) -> Result<LazyFrame, String> {
+    if spans.is_empty() {
+        // Keep the schema of the (empty) result
+        return Ok(apply_filters(scan.clone().slice(0, 0), query, int_filters, None));
+    }
+    let parts: Vec<LazyFrame> = spans
+        .iter()
+        .map(|&(offset, len, covered)| {
+            let part = scan.clone().slice(offset as i64, len as IdxSize);
+            apply_filters(part, query, int_filters, covered)
+        })
+        .collect();
+    concat_parts(parts)
+}
+
+/// Scan of the query's source and its integer filters, with datetime
+/// filters converted to the unit of their column.
+fn open_source(query: &ParquetQuery) -> Result<(LazyFrame, Vec<IntFilter>), String> {
+    let mut lf = match &query.source {
+        QuerySource::Path(path) => {
+            let args = ScanArgsParquet::default();
+            LazyFrame::scan_parquet(path, args).map_err(|e| e.to_string())?
+        }
+        QuerySource::Frame(df) => df.clone().lazy(),
+    };
+
+    let mut int_filters = query.int_filters.clone();
+    if !query.datetime_filters.is_empty() {
+        let schema = lf.collect_schema().map_err(|e| e.to_string())?;
+        for (column, op, epoch_ms) in &query.datetime_filters {
+            int_filters.push(datetime_filter(&schema, column, *op, *epoch_ms)?);
+        }
+    }
+    Ok((lf, int_filters))
+}
+
+/// Apply the query's projection.
+fn project(lf: LazyFrame, query: &ParquetQuery) -> LazyFrame {
+    if query.columns.is_empty() {
+        return lf;
+    }
+    let col_exprs: Vec<_> = query.columns.iter().map(|c| col(c.as_str())).collect();
+    lf.select(col_exprs)
+}
+
+/// Build the lazy plan for a query, optionally restricted to the source
+/// rows [offset, offset + len) before projection and filters.
+///
+/// Full-file scans are narrowed by a key index if one serves the query,
+/// otherwise by sorted row-group statistics where they apply.
+fn build_lazy(query: &ParquetQuery, slice: Option<(usize, usize)>) -> Result<LazyFrame, String> {
+    let (lf, int_filters) = open_source(query)?;
+    let lf = match (&query.source, slice) {
+        // Slice pushdown lets the scan skip row groups outside the range
+        (_, Some((offset, len))) => apply_filters(
+            lf.slice(offset as i64, len as IdxSize),
+            query,
+            &int_filters,
+            None,
+        ),
+        (QuerySource::Path(path), None) if has_range_filter(&int_filters) => {
+            let metadata = key_index::read_metadata(path)?;
+            match plan_spans(path, &metadata, query, &int_filters) {
+                Some(spans) => read_spans(&lf, query, &int_filters, &spans)?,
+                None => apply_filters(lf, query, &int_filters, None),
+            }
+        }
+        (QuerySource::Path(_), None) => apply_filters(lf, query, &int_filters, None),
+        (QuerySource::Frame(_), None) => apply_filters(lf, query, &int_filters, None),
+    };
+    Ok(project(lf, query))
+}
+
+fn execute_query(query: &ParquetQuery) -> Result<DataFrame, String> {
+    if let Some(cancel) = &query.cancel {
+        return execute_cancellable(query, cancel);
+    }
+    build_lazy(query, None)?
+        .collect()
+        .map_err(|e| e.to_string())
+}
+
+/// Cut `spans` at row-group boundaries and group the pieces into windows
+/// touching at most `per_window` row groups each. Pieces that stay
+/// contiguous within a window are merged back. Always returns at least one
+/// (possibly empty) window.
+fn scan_windows<'a>(
+    spans: &[ScanSpan<'a>],
+    groups: &[(usize, usize)],
+    per_window: usize,
+) -> Vec<Vec<ScanSpan<'a>>> {
+    let mut windows: Vec<Vec<ScanSpan>> = Vec::new();
+    let mut window: Vec<ScanSpan> = Vec::new();
+    let mut window_groups = 0;
+    let mut last_group = usize::MAX;
+    for &(offset, len, covered) in spans {
+        let (mut start, end) = (offset, offset + len);
+        while start < end {
+            let g = groups.partition_point(|&(o, l)| o + l <= start);
+            let Some(&(group_offset, group_len)) = groups.get(g) else {
+                break;
+            };
+            let piece_end = end.min(group_offset + group_len);
+            if g != last_group {
+                if window_groups == per_window {
+                    windows.push(std::mem::take(&mut window));
+                    window_groups = 0;
+                }
+                window_groups += 1;
+                last_group = g;
+            }
+            match window.last_mut() {
+                Some(last) if last.2 == covered && last.0 + last.1 == start => {
+                    last.1 += piece_end - start
+                }
+                _ => window.push((start, piece_end - start, covered)),
+            }
+            start = piece_end;
+        }
+    }
+    if !window.is_empty() || windows.is_empty() {
+        windows.push(window);
+    }
+    windows
+}
+
+/// Row groups per window of a cancellable query. One row group keeps the
+/// cancellation checks frequent on files with few, large row groups; the
+/// row group itself still decodes its columns in parallel.
+const CANCEL_WINDOW_ROW_GROUPS: usize = 1;
+
+/// Columns a query has to read: the projected ones plus every filtered
+/// one. `None` (all columns) if the query has no projection.
+fn read_columns(query: &ParquetQuery, int_filters: &[IntFilter]) -> Option<Vec<String>> {
+    if query.columns.is_empty() {
+        return None;
+    }
+    let mut columns = query.columns.clone();
+    let filtered = query
+        .filters
+        .iter()
+        .map(|(column, _)| column)
+        .chain(int_filters.iter().map(|f| &f.column));
+    for column in filtered {
+        if !columns.contains(column) {
+            columns.push(column.clone());
+        }
+    }
+    Some(columns)
+}
+
+/// Read one window of `path` with an eager reader per span that reuses the
+/// footer `metadata` instead of reading it again, then apply the query's
+/// filters and projection.
+fn read_window(
+    path: &str,
+    metadata: &Arc<FileMetadata>,
+    query: &ParquetQuery,
+    int_filters: &[IntFilter],
+    window: &[ScanSpan],
+) -> Result<DataFrame, String> {
+    let columns = read_columns(query, int_filters);
+    let parts = window
+        .iter()
+        .map(|&(offset, len, covered)| {
+            let file = std::fs::File::open(path).map_err(|e| e.to_string())?;
+            let mut reader = polars::io::parquet::read::ParquetReader::new(file);
+            reader.set_metadata(Arc::clone(metadata));
+            let df = reader
+                .with_columns(columns.clone())
+                .with_slice(Some((offset, len)))
+                .finish()
+                .map_err(|e| e.to_string())?;
+            Ok(apply_filters(df.lazy(), query, int_filters, covered))
+        })
+        .collect::<Result<Vec<_>, String>>()?;
+    project(concat_parts(parts)?, query)
+        .collect()
+        .map_err(|e| e.to_string())
+}
+
+/// Execute a file query one row group at a time, checking `cancel` before
+/// each. In-memory queries are a single window.
+///
+/// Spans are planned from the footer (key index or sorted row-group
+/// statistics, as for an uncancellable query), and every window's reader
+/// reuses that footer instead of reading it again. Only the row groups the
+/// spans select are read.
+fn execute_cancellable(query: &ParquetQuery, cancel: &CancelState) -> Result<DataFrame, String> {
+    let QuerySource::Path(path) = &query.source else {
+        cancel.check(1)?;
+        let df = build_lazy(query, None)?
+            .collect()
+            .map_err(|e| e.to_string())?;
+        cancel.record_completed();
+        return Ok(df);
+    };
+
+    let (scan, int_filters) = open_source(query)?;
+    let metadata = key_index::read_metadata(path)?;
+    let groups = key_index::row_group_ranges_of(&metadata);
+    let spans = match plan_spans(path, &metadata, query, &int_filters) {
+        Some(spans) => spans,
+        None => groups.iter().map(|&(offset, len)| (offset, len, None)).collect(),
+    };
+    let windows = scan_windows(&spans, &groups, CANCEL_WINDOW_ROW_GROUPS);
+
+    let mut result: Option<DataFrame> = None;
+    for (i, window) in windows.iter().enumerate() {
+        cancel.check(windows.len() - i)?;
+        let part = if window.is_empty() {
+            // Nothing selected: an empty frame with the query's schema
+            project(read_spans(&scan, query, &int_filters, window)?, query)
+                .collect()
+                .map_err(|e| e.to_string())?
+        } else {
+            read_window(path, &metadata, query, &int_filters, window)?
+        };
+        cancel.record_completed();
+        match &mut result {
+            Some(df) => {
+                df.vstack_mut(&part).map_err(|e| e.to_string())?;
+            }
+            None => result = Some(part),
+        }
+    }
+    Ok(result.unwrap())
 }
 
 fn parquet_query_collect_df(query: Box<ParquetQuery>) -> Result<Box<ParquetDataFrame>, String> {
     let df = execute_query(&query)?;
     Ok(Box::new(ParquetDataFrame { df }))
 }
+
+// ==================== Cancellation Implementation ====================
+
+/// Caller-side handle of a shared `CancelState`.
+pub struct ParquetCancelToken {
+    state: Arc<CancelState>,
+}
+
+fn parquet_cancel_token_new() -> Box<ParquetCancelToken> {
+    Box::new(ParquetCancelToken {
+        state: Arc::default(),
+    })
+}
+
+fn parquet_cancel_token_cancel(token: &ParquetCancelToken) {
+    token.state.cancel();
+}
+
+fn parquet_cancel_token_set_timeout(token: &ParquetCancelToken, timeout_us: u64) {
+    token
+        .state
+        .set_timeout(std::time::Duration::from_micros(timeout_us));
+}
+
+fn parquet_cancel_token_is_cancelled(token: &ParquetCancelToken) -> bool {
+    token.state.is_cancelled()
+}
+
+fn parquet_cancel_token_stats(token: &ParquetCancelToken) -> ffi::CancelStats {
+    let (completed_batches, skipped_batches, cancelled_operations) = token.state.stats();
+    ffi::CancelStats {
+        completed_batches,
+        skipped_batches,
+        cancelled_operations,
+    }
+}
+
+fn parquet_query_set_cancel_token(query: &mut ParquetQuery, token: &ParquetCancelToken) {
+    query.cancel = Some(Arc::clone(&token.state));
+}
+
+// ==================== Streaming Implementation ====================
+
+/// Executes a query one row group at a time so callers hold at most one
+/// decoded row group in memory.
+pub struct ParquetBatchReader {
+    query: ParquetQuery,
+    /// (row offset, row count) of each batch in source order.
+    batches: Vec<(usize, usize)>,
+}
+
+/// Row groups of `path` a query has to read: all of them, minus those that
+/// the spans of the key index or sorted row-group planning do not touch.
+fn planned_row_groups(path: &str, query: &ParquetQuery) -> Result<Vec<(usize, usize)>, String> {
+    let metadata = key_index::read_metadata(path)?;
+    let groups = key_index::row_group_ranges_of(&metadata);
+    let (_, int_filters) = open_source(query)?;
+    if !has_range_filter(&int_filters) {
+        return Ok(groups);
+    }
+    let Some(spans) = plan_spans(path, &metadata, query, &int_filters) else {
+        return Ok(groups);
+    };
+    // Spans are disjoint and in file order
+    Ok(groups
+        .into_iter()
+        .filter(|&(offset, len)| {
+            let next = spans.partition_point(|&(o, l, _)| o + l <= offset);
+            spans.get(next).is_some_and(|&(o, _, _)| o < offset + len)
+        })
+        .collect())
+}
+
+fn parquet_query_batches(query: Box<ParquetQuery>) -> Result<Box<ParquetBatchReader>, String> {
+    let batches = match &query.source {
+        QuerySource::Path(path) => planned_row_groups(path, &query)?,
+        QuerySource::Frame(df) => vec![(0, df.height())],
+    };
+    Ok(Box::new(ParquetBatchReader {
+        query: *query,
+        batches,
+    }))
+}
+
+fn parquet_batch_reader_num_batches(reader: &ParquetBatchReader) -> usize {
+    reader.batches.len()
+}
+
+fn parquet_batch_reader_read(
+    reader: &ParquetBatchReader,
+    index: usize,
+) -> Result<Box<ParquetDataFrame>, String> {
+    let range = *reader
+        .batches
+        .get(index)
+        .ok_or_else(|| format!("Batch index {} out of range", index))?;
+    if let Some(cancel) = &reader.query.cancel {
+        cancel.check(reader.batches.len() - index)?;
+    }
+    let df = build_lazy(&reader.query, Some(range))?
+        .collect()
+        .map_err(|e| e.to_string())?;
+    if let Some(cancel) = &reader.query.cancel {
+        cancel.record_completed();
+    }
+    Ok(Box::new(ParquetDataFrame { df }))
+}
+
+// ==================== Batch Query Implementation ====================
+
+/// Per-key results of a batch query, in ascending key order.
+pub struct ParquetBatchQueryResult {
+    frames: Vec<(i64, DataFrame)>,
+}
+
+fn parquet_batch_query(
+    paths: Vec<String>,
+    key_column: &str,
+    keys: &[i64],
+    columns: Vec<String>,
+) -> Result<Box<ParquetBatchQueryResult>, String> {
+    let mut keys = keys.to_vec();
+    keys.sort_unstable();
+    keys.dedup();
+
+    // The key column is needed to split rows even if it is not projected
+    let mut read_columns = columns.clone();
+    if !read_columns.is_empty() && !read_columns.iter().any(|c| c == key_column) {
+        read_columns.push(key_column.to_string());
+    }
+
+    // One read per file; each read still uses the key index or sorted
+    // row-group planning where available
+    let parts: Vec<DataFrame> = polars_core::POOL.install(|| {
+        paths
+            .par_iter()
+            .map(|path| {
+                let mut query = parquet_query_new(path)?;
+                parquet_query_filter_in_i64(&mut query, key_column, &keys);
+                query.columns = read_columns.clone();
+                execute_query(&query)
+            })
+            .collect::<Result<Vec<_>, String>>()
+    })?;
+
+    let mut parts = parts.into_iter();
+    let mut df = parts.next().unwrap_or_default();
+    for part in parts {
+        df.vstack_mut(&part).map_err(|e| e.to_string())?;
+    }
+
+    // Row indices per key, in file order
+    let mut rows: HashMap<i64, Vec<IdxSize>> = HashMap::with_capacity(keys.len());
+    if df.width() > 0 {
+        let key_values = df
+            .column(key_column)
+            .map_err(|e| e.to_string())?
+            .cast(&DataType::Int64)
+            .map_err(|e| e.to_string())?;
+        let key_values = key_values
+            .as_materialized_series()
+            .i64()
+            .map_err(|e| e.to_string())?;
+        for (row, key) in key_values.into_iter().enumerate() {
+            if let Some(key) = key {
+                rows.entry(key).or_default().push(row as IdxSize);
+            }
+        }
+        if !columns.is_empty() {
+            df = df.select(columns).map_err(|e| e.to_string())?;
+        }
+    }
+
+    let frames = polars_core::POOL.install(|| {
+        keys.par_iter()
+            .map(|&key| {
+                let idx = IdxCa::from_vec(PlSmallStr::EMPTY, rows.get(&key).cloned().unwrap_or_default());
+                df.take(&idx).map(|frame| (key, frame)).map_err(|e| e.to_string())
+            })
+            .collect::<Result<Vec<_>, String>>()
+    })?;
+    Ok(Box::new(ParquetBatchQueryResult { frames }))
+}
+
+fn parquet_batch_query_num_keys(result: &ParquetBatchQueryResult) -> usize {
+    result.frames.len()
+}
+
+fn parquet_batch_query_key(result: &ParquetBatchQueryResult, index: usize) -> i64 {
+    result.frames[index].0
+}
+
+fn parquet_batch_query_frame(result: &ParquetBatchQueryResult, index: usize) -> Box<ParquetDataFrame> {
+    Box::new(ParquetDataFrame {
+        df: result.frames[index].1.clone(),
+    })
+}
+
+// ==================== Async Task Implementation ====================
+
+/// Outcome of a task, filled in by the pool job before it calls back.
+#[derive(Default)]
+struct TaskState {
+    frame: Option<DataFrame>,
+    writer: Option<ParquetWriter>,
+    error: Option<String>,
+}
+
+/// Handle to one background operation; the pool job holds a clone of the
+/// state, so the handle may be read as soon as the callback fires.
+pub struct ParquetTask {
+    state: Arc<Mutex<TaskState>>,
+}
+
+fn parquet_task_new() -> Box<ParquetTask> {
+    Box::new(ParquetTask {
+        state: Arc::default(),
+    })
+}
+
+/// Run `job` on the Polars pool, store its outcome, then notify C++.
+fn spawn_task<F>(task: &ParquetTask, ctx: usize, job: F)
+where
+    F: FnOnce() -> TaskState + Send + 'static,
+{
+    let state = Arc::clone(&task.state);
+    polars_core::POOL.spawn(move || {
+        let outcome = job();
+        *state.lock().unwrap() = outcome;
+        ffi::parquet_task_complete(ctx);
+    });
+}
+
+fn frame_state(result: Result<DataFrame, String>) -> TaskState {
+    match result {
+        Ok(df) => TaskState {
+            frame: Some(df),
+            ..Default::default()
+        },
+        Err(e) => TaskState {
+            error: Some(e),
+            ..Default::default()
+        },
+    }
+}
+
+fn parquet_task_open(task: &ParquetTask, path: &str, ctx: usize) {
+    let path = path.to_string();
+    spawn_task(task, ctx, move || {
+        frame_state(PolarsReader::new(&path).read().map_err(|e| e.to_string()))
+    });
+}
+
+fn parquet_task_collect(task: &ParquetTask, query: Box<ParquetQuery>, ctx: usize) {
+    spawn_task(task, ctx, move || frame_state(execute_query(&query)));
+}
+
+fn parquet_task_write_batch(task: &ParquetTask, writer: &mut ParquetWriter, ctx: usize) {
+    let mut writer = writer.detach();
+    spawn_task(task, ctx, move || {
+        let result = parquet_writer_write_batch(&mut writer);
+        TaskState {
+            writer: Some(writer),
+            error: result.err(),
+            ..Default::default()
+        }
+    });
+}
+
+fn parquet_task_take_frame(task: &ParquetTask) -> Result<Box<ParquetDataFrame>, String> {
+    let mut state = task.state.lock().unwrap();
+    if let Some(e) = state.error.take() {
+        return Err(e);
+    }
+    let df = state
+        .frame
+        .take()
+        .ok_or_else(|| "Task has no DataFrame result".to_string())?;
+    Ok(Box::new(ParquetDataFrame { df }))
+}
+
+fn parquet_task_restore_writer(task: &ParquetTask, writer: &mut ParquetWriter) -> Result<(), String> {
+    *writer = task
+        .state
+        .lock()
+        .unwrap()
+        .writer
+        .take()
+        .ok_or_else(|| "Task has no writer".to_string())?;
+    Ok(())
+}
+
+fn parquet_task_check(task: &ParquetTask) -> Result<(), String> {
+    match task.state.lock().unwrap().error.take() {
+        Some(e) => Err(e),
+        None => Ok(()),
+    }
+}
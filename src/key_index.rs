@@ -0,0 +1,283 @@
+//! Sidecar key index for point reads on files not sorted by key.
+//!
+//! `build_key_index(path, column)` scans one integer key column and writes
+//! `<path>.<column>.keyidx`, mapping each key to the row spans that contain
+//! it (at most one span per row group, adjacent spans coalesced). Queries
+//! with an equality / membership filter on the column read only those spans.
+//!
+//! The sidecar records the data file's size and mtime and is ignored once
+//! either changes.
+//!
+//! Layout (little-endian):
+//! ```text
+//! magic        [u8; 8]  "BRSKIDX1"
+//! file_size    u64
+//! mtime_secs   u64
+//! mtime_nanos  u32
+//! num_keys     u64
+//! keys         num_keys x (key: i64, first_span: u64, span_count: u32), sorted
+//! spans        total x (start_row: u64, num_rows: u64)
+//! ```
+
+use crate::parquet::ParquetReader as PolarsReader;
+use polars::prelude::*;
+use polars_core::POOL;
+use polars_parquet::parquet::metadata::FileMetadata;
+use rayon::prelude::*;
+use std::collections::{BTreeMap, HashMap};
+use std::fs::File;
+use std::io::{BufReader, BufWriter, Read, Seek, SeekFrom, Write};
+use std::sync::Arc;
+use std::time::UNIX_EPOCH;
+
+const MAGIC: &[u8; 8] = b"BRSKIDX1";
+const HEADER_LEN: u64 = 8 + 8 + 8 + 4 + 8;
+const KEY_ENTRY_LEN: u64 = 8 + 8 + 4;
+const SPAN_LEN: u64 = 8 + 8;
+
+/// Spans of the same key closer than this many rows are merged: reading a
+/// few extra rows is cheaper than another slice of the scan.
+const MERGE_GAP_ROWS: u64 = 4096;
+
+/// Path of the sidecar index for `column` of `path`.
+pub fn sidecar_path(path: &str, column: &str) -> String {
+    format!("{}.{}.keyidx", path, column)
+}
+
+/// (size, mtime secs, mtime nanos) identifying the current file contents.
+fn file_stamp(path: &str) -> std::io::Result<(u64, u64, u32)> {
+    let meta = std::fs::metadata(path)?;
+    let mtime = meta
+        .modified()?
+        .duration_since(UNIX_EPOCH)
+        .unwrap_or_default();
+    Ok((meta.len(), mtime.as_secs(), mtime.subsec_nanos()))
+}
+
+/// Footer metadata of a Parquet file.
+pub fn read_metadata(path: &str) -> Result<Arc<FileMetadata>, String> {
+    let file = File::open(path).map_err(|e| e.to_string())?;
+    let mut reader = polars::io::parquet::read::ParquetReader::new(file);
+    let metadata = reader.get_metadata().map_err(|e| e.to_string())?;
+    Ok(Arc::clone(metadata))
+}
+
+/// Row ranges (offset, count) of the row groups in a Parquet file.
+pub fn row_group_ranges(path: &str) -> Result<Vec<(usize, usize)>, String> {
+    Ok(row_group_ranges_of(&read_metadata(path)?))
+}
+
+/// Row ranges (offset, count) of the row groups described by `metadata`.
+pub fn row_group_ranges_of(metadata: &FileMetadata) -> Vec<(usize, usize)> {
+    let mut offset = 0;
+    metadata
+        .row_groups
+        .iter()
+        .map(|rg| {
+            let range = (offset, rg.num_rows());
+            offset += rg.num_rows();
+            range
+        })
+        .collect()
+}
+
+/// First and one-past-last row of each key within one row group.
+fn index_row_group(keys: &Int64Chunked, offset: usize, len: usize) -> HashMap<i64, (u64, u64)> {
+    let mut spans: HashMap<i64, (u64, u64)> = HashMap::new();
+    for (i, key) in keys.slice(offset as i64, len).into_iter().enumerate() {
+        if let Some(key) = key {
+            let row = (offset + i) as u64;
+            spans
+                .entry(key)
+                .and_modify(|span| span.1 = row + 1)
+                .or_insert((row, row + 1));
+        }
+    }
+    spans
+}
+
+/// Build (or rebuild) the sidecar index for an integer key column.
+///
+/// Row groups are indexed in parallel on the Polars thread pool, then
+/// merged in file order. Null keys are not indexed.
+pub fn build_key_index(path: &str, column: &str) -> Result<(), String> {
+    let stamp = file_stamp(path).map_err(|e| e.to_string())?;
+    let groups = row_group_ranges(path)?;
+
+    let df = PolarsReader::new(path)
+        .with_columns([column])
+        .read()
+        .map_err(|e| e.to_string())?;
+    let keys = df
+        .column(column)
+        .map_err(|e| e.to_string())?
+        .cast(&DataType::Int64)
+        .map_err(|e| e.to_string())?;
+    let keys = keys
+        .as_materialized_series()
+        .i64()
+        .map_err(|e| e.to_string())?;
+
+    let per_group: Vec<HashMap<i64, (u64, u64)>> = POOL.install(|| {
+        groups
+            .par_iter()
+            .map(|&(offset, len)| index_row_group(keys, offset, len))
+            .collect()
+    });
+
+    let mut index: BTreeMap<i64, Vec<(u64, u64)>> = BTreeMap::new();
+    for group in per_group {
+        for (key, (start, end)) in group {
+            let spans = index.entry(key).or_default();
+            match spans.last_mut() {
+                Some(last) if start - last.1 <= MERGE_GAP_ROWS => last.1 = end,
+                _ => spans.push((start, end)),
+            }
+        }
+    }
+
+    write_sidecar(&sidecar_path(path, column), stamp, &index).map_err(|e| e.to_string())
+}
+
+fn write_sidecar(
+    sidecar: &str,
+    stamp: (u64, u64, u32),
+    index: &BTreeMap<i64, Vec<(u64, u64)>>,
+) -> std::io::Result<()> {
+    // Write to a temporary file and rename so readers never see a partial index
+    let tmp = format!("{}.tmp", sidecar);
+    {
+        let mut out = BufWriter::new(File::create(&tmp)?);
+        out.write_all(MAGIC)?;
+        out.write_all(&stamp.0.to_le_bytes())?;
+        out.write_all(&stamp.1.to_le_bytes())?;
+        out.write_all(&stamp.2.to_le_bytes())?;
+        out.write_all(&(index.len() as u64).to_le_bytes())?;
+
+        let mut first_span = 0u64;
+        for (key, spans) in index {
+            out.write_all(&key.to_le_bytes())?;
+            out.write_all(&first_span.to_le_bytes())?;
+            out.write_all(&(spans.len() as u32).to_le_bytes())?;
+            first_span += spans.len() as u64;
+        }
+        for spans in index.values() {
+            for &(start, end) in spans {
+                out.write_all(&start.to_le_bytes())?;
+                out.write_all(&(end - start).to_le_bytes())?;
+            }
+        }
+        out.flush()?;
+    }
+    std::fs::rename(&tmp, sidecar)
+}
+
+fn read_u64(r: &mut impl Read) -> std::io::Result<u64> {
+    let mut buf = [0u8; 8];
+    r.read_exact(&mut buf)?;
+    Ok(u64::from_le_bytes(buf))
+}
+
+fn read_u32(r: &mut impl Read) -> std::io::Result<u32> {
+    let mut buf = [0u8; 4];
+    r.read_exact(&mut buf)?;
+    Ok(u32::from_le_bytes(buf))
+}
+
+/// Row spans (offset, count) containing any of `keys`, sorted and merged.
+///
+/// Returns `Ok(None)` if there is no sidecar or it is stale.
+pub fn lookup(
+    path: &str,
+    column: &str,
+    keys: &[i64],
+) -> std::io::Result<Option<Vec<(usize, usize)>>> {
+    let sidecar = sidecar_path(path, column);
+    let file = match File::open(&sidecar) {
+        Ok(f) => f,
+        Err(e) if e.kind() == std::io::ErrorKind::NotFound => return Ok(None),
+        Err(e) => return Err(e),
+    };
+    let mut r = BufReader::new(file);
+
+    let mut magic = [0u8; 8];
+    r.read_exact(&mut magic)?;
+    let stamp = (read_u64(&mut r)?, read_u64(&mut r)?, read_u32(&mut r)?);
+    if &magic != MAGIC || stamp != file_stamp(path)? {
+        return Ok(None);
+    }
+
+    let num_keys = read_u64(&mut r)?;
+    let mut table = Vec::with_capacity(num_keys as usize);
+    for _ in 0..num_keys {
+        let key = read_u64(&mut r)? as i64;
+        let first_span = read_u64(&mut r)?;
+        let span_count = read_u32(&mut r)?;
+        table.push((key, first_span, span_count));
+    }
+
+    let spans_base = HEADER_LEN + num_keys * KEY_ENTRY_LEN;
+    let mut spans = Vec::new();
+    for key in keys {
+        let Ok(pos) = table.binary_search_by_key(key, |entry| entry.0) else {
+            continue;
+        };
+        let (_, first_span, span_count) = table[pos];
+        r.seek(SeekFrom::Start(spans_base + first_span * SPAN_LEN))?;
+        for _ in 0..span_count {
+            let start = read_u64(&mut r)? as usize;
+            let len = read_u64(&mut r)? as usize;
+            spans.push((start, len));
+        }
+    }
+
+    // Union over keys: sort and merge overlapping or touching spans
+    spans.sort_unstable();
+    let mut merged: Vec<(usize, usize)> = Vec::with_capacity(spans.len());
+    for (start, len) in spans {
+        match merged.last_mut() {
+            Some(last) if start <= last.0 + last.1 => {
+                last.1 = last.1.max(start + len - last.0);
+            }
+            _ => merged.push((start, len)),
+        }
+    }
+    Ok(Some(merged))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::parquet::ParquetWriter;
+    use tempfile::tempdir;
+
+    #[test]
+    fn test_build_and_lookup() -> std::result::Result<(), String> {
+        let dir = tempdir().map_err(|e| e.to_string())?;
+        let path = dir.path().join("keys.parquet");
+        let path = path.to_str().unwrap();
+
+        // Keys clustered in runs of 10000 rows, 5000-row groups
+        let ids: Vec<i64> = (0..40_000).map(|i| i / 10_000).collect();
+        let mut df = df! { "id" => ids }.map_err(|e| e.to_string())?;
+        ParquetWriter::new(path)
+            .with_row_group_size(5_000)
+            .write(&mut df)
+            .map_err(|e| e.to_string())?;
+
+        build_key_index(path, "id")?;
+        let spans = lookup(path, "id", &[2]).map_err(|e| e.to_string())?;
+        assert_eq!(spans, Some(vec![(20_000, 10_000)]));
+
+        let spans = lookup(path, "id", &[0, 3, 7]).map_err(|e| e.to_string())?;
+        assert_eq!(spans, Some(vec![(0, 10_000), (30_000, 10_000)]));
+
+        // Rewriting the file invalidates the sidecar
+        std::thread::sleep(std::time::Duration::from_millis(10));
+        ParquetWriter::new(path)
+            .write(&mut df.head(Some(100)))
+            .map_err(|e| e.to_string())?;
+        assert_eq!(lookup(path, "id", &[0]).map_err(|e| e.to_string())?, None);
+        Ok(())
+    }
+}
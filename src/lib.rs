@@ -2,8 +2,11 @@
 //!
 //! This crate provides various data processing utilities.
 
+pub mod cancel;
 pub mod cxx_bridge;
+pub mod key_index;
 pub mod parquet;
+pub mod row_group_plan;
 
 // Re-export commonly used items
 pub use parquet::{ParquetError, ParquetReader, ParquetWriter};
@@ -0,0 +1,257 @@
+//! Row-group planning for range filters on sorted files.
+//!
+//! When the row-group statistics of an integer column are monotonic (each
+//! group's min/max lies at or above the previous group's max), a range
+//! filter on that column maps to a contiguous run of row groups, found by
+//! binary search over the footer alone:
+//!
+//! - groups whose [min, max] lies entirely inside the range are *covered*
+//!   and read without evaluating the range predicate;
+//! - the (at most two) groups straddling a range bound are *boundary*
+//!   groups and keep the predicate;
+//! - all other groups are not read.
+//!
+//! Only integer physical columns (Int32/Int64, which includes Date and
+//! Datetime) without nulls are planned: statistics exclude nulls and NaNs,
+//! so a covered group of such a column could otherwise contain rows the
+//! predicate rejects.
+
+use polars::prelude::*;
+use polars_parquet::parquet::metadata::FileMetadata;
+use polars_parquet::parquet::statistics::Statistics;
+use std::fs::File;
+
+/// Row range and column statistics of one row group.
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub struct GroupStats {
+    pub offset: usize,
+    pub len: usize,
+    pub min: i64,
+    pub max: i64,
+}
+
+/// Comparison a range bound is built from.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum RangeOp {
+    Eq,
+    Lt,
+    Le,
+    Gt,
+    Ge,
+}
+
+/// Conjunction of range comparisons on one column, as (value, inclusive).
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct RangeBounds {
+    pub lower: Option<(i64, bool)>,
+    pub upper: Option<(i64, bool)>,
+}
+
+impl RangeBounds {
+    /// Narrow the bounds by `column <op> value`.
+    pub fn add(&mut self, op: RangeOp, value: i64) {
+        let (lower, upper) = match op {
+            RangeOp::Eq => (Some((value, true)), Some((value, true))),
+            RangeOp::Gt => (Some((value, false)), None),
+            RangeOp::Ge => (Some((value, true)), None),
+            RangeOp::Lt => (None, Some((value, false))),
+            RangeOp::Le => (None, Some((value, true))),
+        };
+        if let Some(l) = lower {
+            self.lower = Some(match self.lower {
+                // Tighter bound wins; on a tie the exclusive one is tighter
+                Some(cur) if cur.0 > l.0 || (cur.0 == l.0 && !cur.1) => cur,
+                _ => l,
+            });
+        }
+        if let Some(u) = upper {
+            self.upper = Some(match self.upper {
+                Some(cur) if cur.0 < u.0 || (cur.0 == u.0 && !cur.1) => cur,
+                _ => u,
+            });
+        }
+    }
+
+    fn above_lower(&self, v: i64) -> bool {
+        match self.lower {
+            Some((l, true)) => v >= l,
+            Some((l, false)) => v > l,
+            None => true,
+        }
+    }
+
+    fn below_upper(&self, v: i64) -> bool {
+        match self.upper {
+            Some((u, true)) => v <= u,
+            Some((u, false)) => v < u,
+            None => true,
+        }
+    }
+}
+
+/// Statistics of `column` per row group, or `None` if the column cannot be
+/// planned (not an integer column, missing statistics, nulls, or min/max
+/// not monotonic across groups).
+pub fn sorted_int_stats(path: &str, column: &str) -> Result<Option<Vec<GroupStats>>, String> {
+    let file = File::open(path).map_err(|e| e.to_string())?;
+    let mut reader = polars::io::parquet::read::ParquetReader::new(file);
+    let metadata = reader.get_metadata().map_err(|e| e.to_string())?;
+    Ok(sorted_int_stats_of(metadata, column))
+}
+
+/// `sorted_int_stats` from already-read footer metadata.
+pub fn sorted_int_stats_of(metadata: &FileMetadata, column: &str) -> Option<Vec<GroupStats>> {
+    let mut groups = Vec::with_capacity(metadata.row_groups.len());
+    let mut offset = 0;
+    for rg in &metadata.row_groups {
+        // Nested columns have several leaves and no single ordering
+        let mut chunks = match rg.columns_under_root_iter(column) {
+            Some(chunks) if chunks.len() == 1 => chunks,
+            _ => return None,
+        };
+        let chunk = chunks.next().unwrap();
+        let stats = match chunk.statistics() {
+            Some(Ok(stats)) => stats,
+            _ => return None,
+        };
+        let (min, max, null_count) = match &stats {
+            Statistics::Int32(s) => (
+                s.min_value.map(i64::from),
+                s.max_value.map(i64::from),
+                s.null_count,
+            ),
+            Statistics::Int64(s) => (s.min_value, s.max_value, s.null_count),
+            _ => return None,
+        };
+        let len = rg.num_rows();
+        if len > 0 {
+            match (min, max, null_count) {
+                (Some(min), Some(max), Some(0)) => groups.push(GroupStats {
+                    offset,
+                    len,
+                    min,
+                    max,
+                }),
+                _ => return None,
+            }
+        }
+        offset += len;
+    }
+
+    let monotonic = groups
+        .windows(2)
+        .all(|w| w[0].min <= w[0].max && w[0].max <= w[1].min);
+    let last_ok = groups.last().map_or(true, |g| g.min <= g.max);
+    (monotonic && last_ok).then_some(groups)
+}
+
+/// Row spans (offset, len, covered) to read for `bounds`, in file order.
+/// Adjacent groups with the same coverage are coalesced into one span.
+pub fn plan(groups: &[GroupStats], bounds: &RangeBounds) -> Vec<(usize, usize, bool)> {
+    // min and max are both non-decreasing, so every predicate below is
+    // monotonic over the group index and partition_point applies
+    let first = groups.partition_point(|g| !bounds.above_lower(g.max));
+    let end = groups.partition_point(|g| bounds.below_upper(g.min));
+    if first >= end {
+        return Vec::new();
+    }
+    let run = &groups[first..end];
+    let covered_begin = first + run.partition_point(|g| !bounds.above_lower(g.min));
+    let covered_end = first + run.partition_point(|g| bounds.below_upper(g.max));
+
+    let mut spans: Vec<(usize, usize, bool)> = Vec::new();
+    for (i, g) in groups.iter().enumerate().take(end).skip(first) {
+        let covered = covered_begin <= i && i < covered_end;
+        match spans.last_mut() {
+            Some(last) if last.2 == covered && last.0 + last.1 == g.offset => last.1 += g.len,
+            _ => spans.push((g.offset, g.len, covered)),
+        }
+    }
+    spans
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::parquet::ParquetWriter;
+    use tempfile::tempdir;
+
+    fn group(offset: usize, min: i64, max: i64) -> GroupStats {
+        GroupStats {
+            offset,
+            len: 100,
+            min,
+            max,
+        }
+    }
+
+    #[test]
+    fn test_plan_range() {
+        // Groups cover [0, 99], [100, 199], ... [900, 999]
+        let groups: Vec<_> = (0..10)
+            .map(|i| group(i * 100, i as i64 * 100, i as i64 * 100 + 99))
+            .collect();
+
+        let mut bounds = RangeBounds::default();
+        bounds.add(RangeOp::Ge, 150);
+        bounds.add(RangeOp::Lt, 500);
+        assert_eq!(
+            plan(&groups, &bounds),
+            vec![(100, 100, false), (200, 300, true)]
+        );
+
+        // Bounds on group edges: every selected group is covered
+        let mut bounds = RangeBounds::default();
+        bounds.add(RangeOp::Ge, 200);
+        bounds.add(RangeOp::Le, 399);
+        assert_eq!(plan(&groups, &bounds), vec![(200, 200, true)]);
+
+        // Point lookup inside one group
+        let mut bounds = RangeBounds::default();
+        bounds.add(RangeOp::Eq, 742);
+        assert_eq!(plan(&groups, &bounds), vec![(700, 100, false)]);
+
+        // Out of range, and the tightest bound wins
+        let mut bounds = RangeBounds::default();
+        bounds.add(RangeOp::Gt, 999);
+        assert!(plan(&groups, &bounds).is_empty());
+        bounds.add(RangeOp::Gt, 100);
+        assert_eq!(bounds.lower, Some((999, false)));
+    }
+
+    #[test]
+    fn test_sorted_int_stats() -> std::result::Result<(), String> {
+        let dir = tempdir().map_err(|e| e.to_string())?;
+        let sorted = dir.path().join("sorted.parquet");
+        let sorted = sorted.to_str().unwrap();
+        let unsorted = dir.path().join("unsorted.parquet");
+        let unsorted = unsorted.to_str().unwrap();
+
+        let ids: Vec<i64> = (0..4_000).collect();
+        let mut df = df! { "id" => ids.clone() }.map_err(|e| e.to_string())?;
+        ParquetWriter::new(sorted)
+            .with_row_group_size(1_000)
+            .write(&mut df)
+            .map_err(|e| e.to_string())?;
+        let stats = sorted_int_stats(sorted, "id")?.expect("monotonic");
+        assert_eq!(stats.len(), 4);
+        assert_eq!(
+            stats[2],
+            GroupStats {
+                offset: 2_000,
+                len: 1_000,
+                min: 2_000,
+                max: 2_999
+            }
+        );
+
+        let mut df =
+            df! { "id" => ids.into_iter().rev().collect::<Vec<_>>() }.map_err(|e| e.to_string())?;
+        ParquetWriter::new(unsorted)
+            .with_row_group_size(1_000)
+            .write(&mut df)
+            .map_err(|e| e.to_string())?;
+        assert_eq!(sorted_int_stats(unsorted, "id")?, None);
+        Ok(())
+    }
+}